@@ -0,0 +1,583 @@
+// hp3d_bench: asset pipeline timings against the shipped level 01 and Harry data.
+//
+// Times the stages that App::load_model and App::load_texture are built from,
+// and writes JSON so results from two builds can be diffed:
+//   obj          tinyobj parse (MB/s of OBJ + MTL text) and triangle bucketing, per mesh
+//   png_decode   stbi_load_from_memory, per texture
+//   gl_upload    upload_texture / upload_submesh through glFinish, MB/s
+//   arena        Arena::alloc + reset vs malloc/free over the same size sequence
+//
+// Each case runs --warmup untimed passes, then --repeats timed ones. The JSON
+// has the mean, stddev, min and max of those repeats. Files are read into memory before
+// timing starts, so disk speed is not part of any number. Missing files are
+// reported as skipped (the OBJs are not in every checkout).
+//
+// GL runs on a hidden GLFW window. Headless, under Mesa:
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./hp3d_bench
+//
+// Usage (from the build dir, like hp3d; paths are ../assets/...):
+//   hp3d_bench [--repeats N] [--warmup N] [--out results.json] [--no-gl]
+//
+// Results go to --out or stdout; every log line goes to stderr.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "arena.hpp"
+#include "asset_pack.hpp"
+#include "level.hpp"
+#include "memory_tracker.hpp"
+#include "mesh_data.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const kMeshPaths[] = {
+    "../assets/levels/01/Adv1Willow.obj",
+    "../assets/skharrymesh.obj",
+};
+const char* const kTextureDirs[] = {
+    "../assets/levels/01",
+    "../assets",
+};
+
+double ms_since(Clock::time_point t) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+}
+
+double to_mb(double bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+// Points fd 1 at stderr and returns a stream on the original stdout. The code
+// under test logs with std::cout (OBJ warnings, load messages); none of that
+// may land in the JSON.
+FILE* take_stdout() {
+    fflush(stdout);
+#ifdef _WIN32
+    int fd = _dup(_fileno(stdout));
+    _dup2(_fileno(stderr), _fileno(stdout));
+    return fd >= 0 ? _fdopen(fd, "wb") : nullptr;
+#else
+    int fd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    return fd >= 0 ? fdopen(fd, "w") : nullptr;
+#endif
+}
+
+struct Settings {
+    int repeats = 10;
+    int warmup = 2;
+    const char* outPath = nullptr;
+    bool gl = true;
+};
+
+// Over the timed repeats, in milliseconds (stddev is the sample stddev)
+struct Stats {
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+};
+
+Stats summarize(const std::vector<double>& samples) {
+    Stats s;
+    if (samples.empty()) return s;
+    double sum = 0.0;
+    for (double v : samples) sum += v;
+    s.mean = sum / samples.size();
+    double var = 0.0;
+    for (double v : samples) var += (v - s.mean) * (v - s.mean);
+    s.stddev = samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0.0;
+    s.min = *std::min_element(samples.begin(), samples.end());
+    s.max = *std::max_element(samples.begin(), samples.end());
+    return s;
+}
+
+// Warmup, then one sample per repeat of the whole of run()
+template <typename Fn>
+Stats measure(const Settings& settings, Fn&& run) {
+    for (int i = 0; i < settings.warmup; ++i) run();
+    std::vector<double> samples(settings.repeats);
+    for (double& sample : samples) {
+        auto start = Clock::now();
+        run();
+        sample = ms_since(start);
+    }
+    return summarize(samples);
+}
+
+// Just enough JSON for nested objects/arrays of numbers and strings
+struct JsonWriter {
+    std::string out;
+    std::vector<bool> first;    // Per open scope: nothing written in it yet
+
+    void begin_object(const char* key = nullptr) { open(key, '{'); }
+    void end_object() { close('}'); }
+    void begin_array(const char* key = nullptr) { open(key, '['); }
+    void end_array() { close(']'); }
+
+    void number(const char* key, double value) {
+        prefix(key);
+        char buf[64];
+        if (!std::isfinite(value)) snprintf(buf, sizeof(buf), "null");
+        else if (value == std::floor(value) && std::fabs(value) < 1e15) snprintf(buf, sizeof(buf), "%.0f", value);  // Counts, bytes
+        else snprintf(buf, sizeof(buf), "%.6g", value);
+        out += buf;
+    }
+
+    void string(const char* key, const std::string& value) {
+        prefix(key);
+        out += '"';
+        for (char c : value) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        out += '"';
+    }
+
+    void stats(const char* key, const Stats& s) {
+        begin_object(key);
+        number("mean_ms", s.mean);
+        number("stddev_ms", s.stddev);
+        number("min_ms", s.min);
+        number("max_ms", s.max);
+        end_object();
+    }
+
+private:
+    void prefix(const char* key) {
+        if (!first.empty()) {
+            if (!first.back()) out += ',';
+            first.back() = false;
+            out += '\n';
+            out.append(first.size() * 2, ' ');
+        }
+        if (key) {
+            out += '"';
+            out += key;
+            out += "\": ";
+        }
+    }
+
+    void open(const char* key, char bracket) {
+        prefix(key);
+        out += bracket;
+        first.push_back(true);
+    }
+
+    void close(char bracket) {
+        bool empty = first.back();
+        first.pop_back();
+        if (!empty) {
+            out += '\n';
+            out.append(first.size() * 2, ' ');
+        }
+        out += bracket;
+    }
+};
+
+struct Texture {
+    std::string path;
+    AssetView file;
+    unsigned char* pixels = nullptr;    // Decoded once for the upload case
+    int width = 0, height = 0, channels = 0;
+};
+
+// --- OBJ parse + bucketing ---
+void bench_obj(const Settings& settings, const AssetSource& assets, Arena& staging, std::vector<MeshData>& meshes,
+               JsonWriter& json) {
+    json.begin_array("obj");
+    for (const char* path : kMeshPaths) {
+        json.begin_object();
+        json.string("file", path);
+
+        AssetView obj;
+        if (!assets.load(path, staging, obj)) {
+            json.string("skipped", "file not found");
+            json.end_object();
+            fprintf(stderr, "[bench] obj %s: not found, skipped\n", path);
+            continue;
+        }
+
+        // Files the OBJ pulls in (its MTL) are read on the first, untimed parse and
+        // served from memory after that; a missing one stays missing
+        struct CachedFile {
+            std::string path;
+            bool found;
+            AssetView view;
+        };
+        std::vector<CachedFile> cache;
+        MeshFileLoader loader = [&](const std::string& file, AssetView& out) {
+            for (const CachedFile& cached : cache) {
+                if (cached.path != file) continue;
+                out = cached.view;
+                return cached.found;
+            }
+            CachedFile cached{ file, false, {} };
+            cached.found = assets.load(file.c_str(), staging, cached.view);
+            cache.push_back(cached);
+            out = cached.view;
+            return cached.found;
+        };
+
+        MeshData mesh;
+        bool ok = load_obj_mesh(path, obj, loader, mesh, nullptr);
+        size_t mtlBytes = 0;
+        for (const CachedFile& cached : cache) mtlBytes += cached.found ? cached.view.size : 0;
+
+        std::vector<double> parseSamples, bucketSamples;
+        for (int i = 0; i < settings.warmup + settings.repeats && ok; ++i) {
+            ObjLoadTimings timings;
+            mesh = MeshData();
+            ok = load_obj_mesh(path, obj, loader, mesh, &timings);
+            if (i < settings.warmup) continue;
+            parseSamples.push_back(timings.parseMs);
+            bucketSamples.push_back(timings.bucketMs);
+        }
+        if (!ok) {
+            json.string("skipped", "parse failed");
+            json.end_object();
+            continue;
+        }
+
+        size_t vertexCount = 0;
+        for (const auto& bucket : mesh.buckets) vertexCount += bucket.vertices.size() / mesh.stride;
+        Stats parse = summarize(parseSamples);
+        Stats bucket = summarize(bucketSamples);
+
+        json.number("bytes", (double)obj.size);
+        json.number("mtl_bytes", (double)mtlBytes);
+        json.number("triangles", (double)(vertexCount / 3));
+        json.number("buckets", (double)mesh.buckets.size());
+        json.stats("parse", parse);
+        json.number("parse_mb_s", to_mb((double)(obj.size + mtlBytes)) / (parse.mean / 1000.0));
+        json.stats("bucket", bucket);
+        json.number("bucket_mtri_s", (vertexCount / 3) / 1.0e6 / (bucket.mean / 1000.0));
+        json.end_object();
+
+        fprintf(stderr, "[bench] obj %s: parse %.2f ms (%.1f MB/s), bucket %.2f ms\n", path, parse.mean,
+                to_mb((double)(obj.size + mtlBytes)) / (parse.mean / 1000.0), bucket.mean);
+        meshes.push_back(std::move(mesh));
+    }
+    json.end_array();
+}
+
+// --- PNG decode, per texture ---
+void bench_png(const Settings& settings, std::vector<Texture>& textures, JsonWriter& json) {
+    // Same orientation as App::load_texture
+    stbi_set_flip_vertically_on_load(true);
+
+    json.begin_object("png_decode");
+    json.begin_array("textures");
+    int decoded = 0;
+    double totalMs = 0.0;
+    double totalPixels = 0.0;
+    for (Texture& tex : textures) {
+        tex.pixels = stbi_load_from_memory(tex.file.data, (int)tex.file.size, &tex.width, &tex.height, &tex.channels, 0);
+        if (!tex.pixels) {
+            json.begin_object();
+            json.string("file", tex.path);
+            json.string("skipped", "decode failed");
+            json.end_object();
+            fprintf(stderr, "[bench] png %s: %s, skipped\n", tex.path.c_str(), stbi_failure_reason());
+            continue;
+        }
+        Stats decode = measure(settings, [&]() {
+            int w, h, c;
+            stbi_image_free(stbi_load_from_memory(tex.file.data, (int)tex.file.size, &w, &h, &c, 0));
+        });
+
+        decoded++;
+        double pixels = (double)tex.width * tex.height;
+        totalMs += decode.mean;
+        totalPixels += pixels;
+
+        json.begin_object();
+        json.string("file", tex.path);
+        json.number("bytes", (double)tex.file.size);
+        json.number("width", tex.width);
+        json.number("height", tex.height);
+        json.number("channels", tex.channels);
+        json.stats("decode", decode);
+        json.number("mpix_s", pixels / 1.0e6 / (decode.mean / 1000.0));
+        json.end_object();
+    }
+    json.end_array();
+    json.number("count", decoded);
+    json.number("total_mean_ms", totalMs);
+    json.number("mpix_s", totalMs > 0.0 ? totalPixels / 1.0e6 / (totalMs / 1000.0) : 0.0);
+    json.end_object();
+
+    fprintf(stderr, "[bench] png: %d of %zu textures, %.2f ms total\n", decoded, textures.size(), totalMs);
+}
+
+// --- GL upload (textures with mipmaps, and mesh buffers) ---
+void bench_gl(const Settings& settings, const std::vector<Texture>& textures, const std::vector<MeshData>& meshes,
+              JsonWriter& json) {
+    json.begin_object("gl_upload");
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwInit() ? glfwCreateWindow(64, 64, "hp3d_bench", NULL, NULL) : nullptr;
+    if (!window) {
+        json.string("skipped", "no GL 3.3 context");
+        json.end_object();
+        glfwTerminate();
+        fprintf(stderr, "[bench] gl: no GL 3.3 context, skipped\n");
+        return;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        json.string("skipped", "glad failed to load GL");
+        json.end_object();
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        fprintf(stderr, "[bench] gl: glad failed to load GL, skipped\n");
+        return;
+    }
+    json.string("renderer", (const char*)glGetString(GL_RENDERER));
+    json.string("version", (const char*)glGetString(GL_VERSION));
+
+    // Timed: upload + glFinish. Deleting happens after the sample is taken.
+    auto run = [&](auto&& upload, auto&& release) {
+        std::vector<double> samples;
+        for (int i = 0; i < settings.warmup + settings.repeats; ++i) {
+            glFinish();
+            auto start = Clock::now();
+            upload();
+            glFinish();
+            double ms = ms_since(start);
+            release();
+            if (i >= settings.warmup) samples.push_back(ms);
+        }
+        return summarize(samples);
+    };
+
+    // Textures: the level's whole set, as App / Level::activate upload them
+    std::vector<unsigned int> names;
+    double textureBytes = 0.0;
+    for (const Texture& tex : textures) {
+        if (tex.pixels) textureBytes += (double)tex.width * tex.height * tex.channels;
+    }
+    Stats texStats = run(
+        [&]() {
+            for (const Texture& tex : textures) {
+                if (tex.pixels) names.push_back(upload_texture(tex.pixels, tex.width, tex.height, tex.channels, "bench"));
+            }
+        },
+        [&]() {
+            for (unsigned int name : names) memory_tracker().release(MEM_GL_TEXTURE, name);
+            glDeleteTextures((int)names.size(), names.data());
+            names.clear();
+        });
+    json.begin_object("textures");
+    json.number("bytes", textureBytes);
+    json.stats("upload", texStats);
+    json.number("mb_s", to_mb(textureBytes) / (texStats.mean / 1000.0));
+    json.string("note", "includes glGenerateMipmap");
+    json.end_object();
+    fprintf(stderr, "[bench] gl textures: %.2f MB in %.2f ms\n", to_mb(textureBytes), texStats.mean);
+
+    // Buffers: every bucket of every mesh that loaded
+    std::vector<SubMesh> subMeshes;
+    double bufferBytes = 0.0;
+    for (const MeshData& mesh : meshes) {
+        for (const auto& bucket : mesh.buckets) bufferBytes += (double)bucket.vertices.size() * sizeof(float);
+    }
+    if (bufferBytes > 0.0) {
+        Stats bufStats = run(
+            [&]() {
+                for (const MeshData& mesh : meshes) {
+                    for (const auto& bucket : mesh.buckets) {
+                        subMeshes.push_back(upload_submesh(bucket.vertices.data(), bucket.vertices.size(), mesh.stride, 0, "bench"));
+                    }
+                }
+            },
+            [&]() {
+                for (const SubMesh& sub : subMeshes) {
+                    memory_tracker().release(MEM_GL_BUFFER, sub.vbo);
+                    glDeleteBuffers(1, &sub.vbo);
+                    glDeleteVertexArrays(1, &sub.vao);
+                }
+                subMeshes.clear();
+            });
+        json.begin_object("buffers");
+        json.number("bytes", bufferBytes);
+        json.stats("upload", bufStats);
+        json.number("mb_s", to_mb(bufferBytes) / (bufStats.mean / 1000.0));
+        json.end_object();
+        fprintf(stderr, "[bench] gl buffers: %.2f MB in %.2f ms\n", to_mb(bufferBytes), bufStats.mean);
+    } else {
+        json.begin_object("buffers");
+        json.string("skipped", "no mesh loaded");
+        json.end_object();
+    }
+
+    json.end_object();
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+// --- Arena vs malloc ---
+void bench_arena(const Settings& settings, JsonWriter& json) {
+    static const int kAllocs = 100000;
+
+    // Mixed small sizes, the shape of per-frame scratch (LCG so runs compare)
+    std::vector<unsigned int> sizes(kAllocs);
+    unsigned int seed = 1234567u;
+    size_t total = 0;
+    for (unsigned int& size : sizes) {
+        seed = seed * 1664525u + 1013904223u;
+        size = 16 + (seed >> 8) % 1009;
+        total += size + 8;
+    }
+
+    Arena arena;
+    arena.init(total);
+    std::vector<unsigned char*> blocks(kAllocs);
+    volatile unsigned int sink = 0;
+
+    // Each block is touched once so neither side gets optimized away
+    Stats arenaStats = measure(settings, [&]() {
+        unsigned int sum = 0;
+        for (int i = 0; i < kAllocs; ++i) {
+            unsigned char* p = (unsigned char*)arena.alloc(sizes[i]);
+            p[0] = (unsigned char)i;
+            sum += p[0];
+        }
+        arena.reset();
+        sink = sink + sum;
+    });
+    Stats mallocStats = measure(settings, [&]() {
+        unsigned int sum = 0;
+        for (int i = 0; i < kAllocs; ++i) {
+            blocks[i] = (unsigned char*)malloc(sizes[i]);
+            blocks[i][0] = (unsigned char)i;
+            sum += blocks[i][0];
+        }
+        for (unsigned char* p : blocks) free(p);
+        sink = sink + sum;
+    });
+    arena.destroy();
+
+    json.begin_object("arena");
+    json.number("allocations", kAllocs);
+    json.number("bytes", (double)total);
+    json.stats("arena", arenaStats);
+    json.number("arena_ns_per_alloc", arenaStats.mean * 1.0e6 / kAllocs);
+    json.stats("malloc", mallocStats);
+    json.number("malloc_ns_per_alloc", mallocStats.mean * 1.0e6 / kAllocs);
+    json.number("speedup", mallocStats.mean / arenaStats.mean);
+    json.end_object();
+
+    fprintf(stderr, "[bench] arena %.2f ns/alloc, malloc %.2f ns/alloc\n", arenaStats.mean * 1.0e6 / kAllocs,
+            mallocStats.mean * 1.0e6 / kAllocs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--repeats") && i + 1 < argc) settings.repeats = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) settings.warmup = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--out") && i + 1 < argc) settings.outPath = argv[++i];
+        else if (!strcmp(argv[i], "--no-gl")) settings.gl = false;
+        else {
+            printf("usage: %s [--repeats N] [--warmup N] [--out results.json] [--no-gl]\n", argv[0]);
+            return 1;
+        }
+    }
+    settings.repeats = std::max(1, settings.repeats);
+    settings.warmup = std::max(0, settings.warmup);
+
+    // The JSON gets a stream nothing else writes to: --out, or the real stdout
+    FILE* jsonOut = settings.outPath ? fopen(settings.outPath, "wb") : nullptr;
+    if (settings.outPath && !jsonOut) {
+        fprintf(stderr, "[bench] failed to open %s\n", settings.outPath);
+        return 1;
+    }
+    FILE* realStdout = take_stdout();
+    if (!jsonOut) jsonOut = realStdout;
+    if (!jsonOut) {
+        fprintf(stderr, "[bench] no stream for the results\n");
+        return 1;
+    }
+
+    // No pack mounted, so loose files: this measures the pipeline, not the pack
+    AssetSource assets;
+    Arena staging;
+    staging.init(128 * 1024 * 1024);
+
+    // Every PNG the level (and Harry) ships, read up front in a stable order
+    std::vector<Texture> textures;
+    for (const char* dir : kTextureDirs) {
+        if (!fs::is_directory(dir)) continue;
+        std::vector<std::string> paths;
+        for (const auto& item : fs::directory_iterator(dir)) {
+            if (item.is_regular_file() && item.path().extension() == ".png") paths.push_back(item.path().generic_string());
+        }
+        std::sort(paths.begin(), paths.end());
+        for (const std::string& path : paths) {
+            Texture tex;
+            tex.path = path;
+            if (assets.load(path.c_str(), staging, tex.file)) textures.push_back(tex);
+        }
+    }
+
+    JsonWriter json;
+    json.begin_object();
+    json.string("bench", "hp3d_bench");
+    json.number("repeats", settings.repeats);
+    json.number("warmup", settings.warmup);
+
+    std::vector<MeshData> meshes;
+    bench_obj(settings, assets, staging, meshes, json);
+    bench_png(settings, textures, json);
+    if (settings.gl) {
+        bench_gl(settings, textures, meshes, json);
+    } else {
+        json.begin_object("gl_upload");
+        json.string("skipped", "--no-gl");
+        json.end_object();
+    }
+    bench_arena(settings, json);
+    json.end_object();
+    json.out += '\n';
+
+    for (Texture& tex : textures) stbi_image_free(tex.pixels);
+    staging.destroy();
+
+    fwrite(json.out.data(), 1, json.out.size(), jsonOut);
+    fclose(jsonOut);
+    if (settings.outPath) fprintf(stderr, "[bench] wrote %s\n", settings.outPath);
+    return 0;
+}
@@ -0,0 +1,17 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoords;
+flat in float Text;
+
+uniform sampler2D u_Font;
+
+void main()
+{
+    if (Text < 0.5) {
+        FragColor = vec4(0.0, 0.0, 0.0, 0.6);
+        return;
+    }
+    // 1-bit font: no blending inside glyphs
+    if (texture(u_Font, TexCoords).r < 0.5) discard;
+    FragColor = vec4(1.0);
+}
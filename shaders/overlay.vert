@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;       // Pixels, top-left origin
+layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in float aText;     // 1 = glyph, 0 = background strip
+
+out vec2 TexCoords;
+flat out float Text;
+
+uniform vec2 u_Resolution;
+
+void main()
+{
+    vec2 ndc = aPos / u_Resolution * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    TexCoords = aTexCoords;
+    Text = aText;
+}
@@ -4,36 +4,61 @@ out vec4 FragColor;
 noperspective in vec2 TexCoord;
 in vec3 FragPos;
 in vec3 Normal;
+#ifdef BAKED_LIGHTING
+in vec3 BakedColor; // Ambient, AO and static lights already folded in
+#endif
 
 uniform sampler2D u_Texture;
 
 // Lighting Uniforms
-uniform vec3 u_LightPos;
-uniform vec3 u_LightColor;     // e.g., (1.0, 0.8, 0.6) for fire
-uniform float u_LightRange;    // How far the light reaches
-uniform vec3 u_AmbientColor;   // Base light level (0.2, 0.2, 0.2)
+uniform vec3 u_AmbientColor;   // Base light level (AMBIENT_COLOR in lights.hpp)
+
+// Tiled light list (built on the CPU by LightGrid every frame)
+uniform samplerBuffer u_LightData;     // 2 texels per light: (pos, range), (color, isStatic)
+uniform usamplerBuffer u_LightTiles;   // Per tile: (offset into u_LightIndices, count, dynamic count)
+uniform usamplerBuffer u_LightIndices; // Flat list of light indices
+uniform int u_TileSize;                // Pixels per tile side
+uniform int u_TilesX;                  // Tiles per row
 
 void main()
 {
     vec4 texColor = texture(u_Texture, TexCoord);
     if(texColor.a < 0.1) discard;
 
-    // 1. Ambient
+    // 1. Ambient (the baked variant gets it, plus static lights, per vertex)
+#ifdef BAKED_LIGHTING
+    vec3 ambient = BakedColor;
+#else
     vec3 ambient = u_AmbientColor;
+#endif
 
-    // 2. Diffuse (Directional)
+    // 2. Diffuse, only from the lights binned into this fragment's tile
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(u_LightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
+    ivec2 tile = ivec2(gl_FragCoord.xy) / u_TileSize;
+    uvec3 list = texelFetch(u_LightTiles, tile.y * u_TilesX + tile.x).xyz;
+#ifdef BAKED_LIGHTING
+    uint lightCount = list.z; // Dynamic lights only: static ones are already in BakedColor
+#else
+    uint lightCount = list.y;
+#endif
+
+    vec3 diffuse = vec3(0.0);
+    for (uint i = 0u; i < lightCount; ++i) {
+        int light = int(texelFetch(u_LightIndices, int(list.x + i)).r);
+        vec4 posRange = texelFetch(u_LightData, light * 2);
+        vec3 color = texelFetch(u_LightData, light * 2 + 1).rgb;
+
+        vec3 toLight = posRange.xyz - FragPos;
+        float distance = max(length(toLight), 0.0001);
+        float diff = max(dot(norm, toLight / distance), 0.0);
 
-    // 3. Attenuation (Distance Fade)
-    float distance = length(u_LightPos - FragPos);
-    // Simple Linear fade: 1.0 at center, 0.0 at max range
-    float attenuation = clamp(1.0 - (distance / u_LightRange), 0.0, 1.0);
+        // 3. Attenuation (Simple Linear fade: 1.0 at center, 0.0 at max range)
+        float attenuation = clamp(1.0 - (distance / posRange.w), 0.0, 1.0);
 
-    vec3 diffuse = diff * u_LightColor * attenuation;
+        diffuse += diff * color * attenuation;
+    }
 
     // Combine
     vec3 finalLight = ambient + diffuse;
     FragColor = vec4(texColor.rgb * finalLight, texColor.a);
-}
\ No newline at end of file
+}
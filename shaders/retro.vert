@@ -2,6 +2,15 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal; // <--- NEW: Normals
+#ifdef SKINNING
+layout (location = 4) in uvec4 aJoints;
+layout (location = 5) in vec4 aWeights;
+uniform mat4 u_Joints[32]; // MAX_JOINTS, 3x4 in columns (w row is zero, see compute_skin_matrices)
+#endif
+#ifdef BAKED_LIGHTING
+layout (location = 3) in vec3 aBakedColor; // Ambient * AO + static lights, from hp3d_bake
+out vec3 BakedColor;
+#endif
 
 noperspective out vec2 TexCoord;
 out vec3 FragPos;  // <--- NEW: Position in world space
@@ -14,13 +23,23 @@ uniform vec2 u_SnapResolution;
 
 void main()
 {
+    vec3 localPos = aPos;
+    vec3 localNormal = aNormal;
+#ifdef SKINNING
+    // 0. Linear blend skinning (the GPU alternative to Crowd's SSE path)
+    mat4 skin = u_Joints[aJoints.x] * aWeights.x + u_Joints[aJoints.y] * aWeights.y
+              + u_Joints[aJoints.z] * aWeights.z + u_Joints[aJoints.w] * aWeights.w;
+    localPos = (skin * vec4(aPos, 1.0)).xyz;
+    localNormal = mat3(skin) * aNormal;
+#endif
+
     // 1. Calculate World Position (Unsnapped for lighting math)
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    FragPos = vec3(model * vec4(localPos, 1.0));
 
     // 2. Pass Normal (Rotate it with the model)
     // Note: In a real engine, use a "Normal Matrix" here to handle scaling correctly.
     // For uniform scaling, this is fine.
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = mat3(transpose(inverse(model))) * localNormal;
 
     // 3. Snapping Logic (Same as before)
     vec4 clipPos = projection * view * vec4(FragPos, 1.0);
@@ -30,4 +49,7 @@ void main()
 
     gl_Position = clipPos;
     TexCoord = aTexCoord;
+#ifdef BAKED_LIGHTING
+    BakedColor = aBakedColor;
+#endif
 }
\ No newline at end of file
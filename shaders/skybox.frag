@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+// Perspective-correct on purpose: affine warping across a cube face this big
+// bends the horizon instead of looking "retro".
+in vec3 TexDir;
+
+uniform samplerCube u_Sky;
+
+void main()
+{
+    FragColor = vec4(texture(u_Sky, TexDir).rgb, 1.0);
+}
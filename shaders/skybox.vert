@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+
+out vec3 TexDir;
+
+uniform mat4 view;       // Rotation only (translation stripped on the CPU)
+uniform mat4 projection;
+uniform vec2 u_SnapResolution;
+
+void main()
+{
+    // The cube's own position is the lookup direction
+    TexDir = aPos;
+
+    vec4 clipPos = projection * view * vec4(aPos, 1.0);
+
+    // Same vertex snap as retro.vert so the sky corners wobble with the world
+    vec2 screenPos = clipPos.xy / clipPos.w;
+    screenPos = floor(screenPos * u_SnapResolution) / u_SnapResolution;
+
+    // z = w puts every sky fragment exactly on the far plane (depth 1.0)
+    gl_Position = vec4(screenPos * clipPos.w, clipPos.w, clipPos.w);
+}
@@ -0,0 +1,166 @@
+#include "animation.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+int Skeleton::find(const std::string& name) const {
+    for (int i = 0; i < joint_count(); ++i) {
+        if (names[i] == name) return i;
+    }
+    return -1;
+}
+
+int AnimSet::find_clip(const std::string& name) const {
+    for (int i = 0; i < (int)clips.size(); ++i) {
+        if (clips[i].name == name) return i;
+    }
+    return -1;
+}
+
+bool load_animation(const char* name, const AssetView& file, const glm::vec3& boundsMin, const glm::vec3& boundsMax, AnimSet& out) {
+    glm::vec3 extent = boundsMax - boundsMin;
+    Skeleton& skel = out.skeleton;
+    AnimClip* clip = nullptr;
+
+    int lineNumber = 0;
+    bool ok = true;
+    size_t cursor = 0;
+    while (ok && cursor < file.size) {
+        // Copy one line out so sscanf never runs past the view
+        char line[256];
+        size_t len = 0;
+        while (cursor < file.size && file.data[cursor] != '\n') {
+            if (len < sizeof(line) - 1) line[len++] = (char)file.data[cursor];
+            cursor++;
+        }
+        line[len] = 0;
+        cursor++;
+        lineNumber++;
+
+        char token[64];
+        int parent;
+        float x, y, z, t;
+
+        if (sscanf(line, " joint %63s %d %f %f %f", token, &parent, &x, &y, &z) == 5) {
+            // Parents come first in the file; -1 is the root. Keys are sized by the
+            // joint count, so the skeleton is closed once the first clip starts.
+            if (!out.clips.empty() || parent < -1 || parent >= skel.joint_count() || skel.joint_count() >= MAX_JOINTS) { ok = false; break; }
+            glm::vec3 pos = boundsMin + glm::vec3(x, y, z) * extent;
+            skel.names.push_back(token);
+            skel.parents.push_back(parent);
+            skel.bindPositions.push_back(pos);
+            skel.bindLocal.push_back(parent >= 0 ? pos - skel.bindPositions[parent] : pos);
+        } else if (sscanf(line, " clip %63s %f", token, &t) == 2) {
+            if (!(t > 0.0f)) { ok = false; break; }
+            out.clips.push_back({ token, t, {}, {}, {} });
+            clip = &out.clips.back();
+        } else if (sscanf(line, " key %f %f %f %f", &t, &x, &y, &z) == 4) {
+            // Increasing and inside [0, duration): sample_clip wraps the last key to the first
+            if (!clip || !(t >= 0.0f && t < clip->duration)) { ok = false; break; }
+            if (!clip->times.empty() && !(t > clip->times.back())) { ok = false; break; }
+            clip->times.push_back(t);
+            clip->rootOffsets.push_back(glm::vec3(x, y, z) * extent);
+            clip->rotations.resize(clip->rotations.size() + skel.joint_count(), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        } else if (sscanf(line, " r %63s %f %f %f", token, &x, &y, &z) == 4) {
+            int joint = skel.find(token);
+            if (!clip || clip->times.empty() || joint < 0) { ok = false; break; }
+            size_t key = clip->times.size() - 1;
+            clip->rotations[key * skel.joint_count() + joint] =
+                glm::quat(glm::vec3(glm::radians(x), glm::radians(y), glm::radians(z)));
+        }
+    }
+
+    if (!ok) {
+        std::cout << "Animation parse error at " << name << ":" << lineNumber << std::endl;
+        return false;
+    }
+
+    std::cout << "Loaded Animation: " << skel.joint_count() << " joints, " << out.clips.size() << " clips" << std::endl;
+    return skel.joint_count() > 0;
+}
+
+Pose alloc_pose(const Skeleton& skeleton, Arena& arena) {
+    Pose pose;
+    pose.rotations = arena.alloc_array<glm::quat>(skeleton.joint_count());
+    pose.rootOffset = glm::vec3(0.0f);
+    return pose;
+}
+
+namespace {
+
+// Shortest-path normalized lerp. Close enough to slerp for keys this dense, and much cheaper.
+glm::quat nlerp(const glm::quat& a, const glm::quat& b, float t) {
+    glm::quat target = glm::dot(a, b) < 0.0f ? -b : b;
+    return glm::normalize(a * (1.0f - t) + target * t);
+}
+
+} // namespace
+
+void sample_clip(const AnimSet& set, const AnimClip& clip, float t, Pose& out) {
+    int jointCount = set.skeleton.joint_count();
+    int keyCount = (int)clip.times.size();
+    if (keyCount == 0) {
+        for (int j = 0; j < jointCount; ++j) out.rotations[j] = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        out.rootOffset = glm::vec3(0.0f);
+        return;
+    }
+
+    t = fmodf(t, clip.duration);
+    if (t < 0.0f) t += clip.duration;
+
+    // Find the key pair around t. Keys are few, a linear scan beats a binary search here.
+    int k0 = keyCount - 1;
+    for (int k = 0; k < keyCount - 1; ++k) {
+        if (t < clip.times[k + 1]) { k0 = k; break; }
+    }
+    int k1 = (k0 + 1) % keyCount;
+
+    // The last key wraps around to the first over the rest of the duration
+    float t0 = clip.times[k0];
+    float t1 = k1 > k0 ? clip.times[k1] : clip.duration + clip.times[k1];
+    float alpha = t1 > t0 ? (t - t0) / (t1 - t0) : 0.0f;
+    alpha = glm::clamp(alpha, 0.0f, 1.0f);
+
+    const glm::quat* a = &clip.rotations[k0 * jointCount];
+    const glm::quat* b = &clip.rotations[k1 * jointCount];
+    for (int j = 0; j < jointCount; ++j) {
+        out.rotations[j] = nlerp(a[j], b[j], alpha);
+    }
+    out.rootOffset = glm::mix(clip.rootOffsets[k0], clip.rootOffsets[k1], alpha);
+}
+
+void blend_poses(int jointCount, const Pose& a, const Pose& b, float weight, Pose& out) {
+    for (int j = 0; j < jointCount; ++j) {
+        out.rotations[j] = nlerp(a.rotations[j], b.rotations[j], weight);
+    }
+    out.rootOffset = glm::mix(a.rootOffset, b.rootOffset, weight);
+}
+
+void compute_skin_matrices(const Skeleton& skeleton, const Pose& pose, float* out) {
+    glm::mat4 world[MAX_JOINTS];
+    int jointCount = skeleton.joint_count();
+
+    for (int j = 0; j < jointCount; ++j) {
+        glm::vec3 offset = skeleton.bindLocal[j];
+        int parent = skeleton.parents[j];
+        if (parent < 0) offset += pose.rootOffset;
+
+        glm::mat4 local = glm::mat4_cast(pose.rotations[j]);
+        local[3] = glm::vec4(offset, 1.0f);
+        world[j] = parent >= 0 ? world[parent] * local : local;
+
+        // Bind rotations are identity, so the inverse bind is just a translation
+        glm::mat4 skin = world[j];
+        skin[3] = world[j] * glm::vec4(-skeleton.bindPositions[j], 1.0f);
+
+        float* dst = out + j * 16;
+        for (int c = 0; c < 4; ++c) {
+            dst[c * 4 + 0] = skin[c].x;
+            dst[c * 4 + 1] = skin[c].y;
+            dst[c * 4 + 2] = skin[c].z;
+            dst[c * 4 + 3] = 0.0f;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "arena.hpp"
+#include "asset_pack.hpp"
+
+// Skeletons and clips come from a small text format (.hpanim), see assets/skharry.hpanim:
+//
+//   joint <name> <parent|-1> <x> <y> <z>   bind position, in mesh-bounds space (0..1 per axis)
+//   clip  <name> <duration>
+//   key   <time> <rootX> <rootY> <rootZ>   root offset, also in bounds space
+//   r     <joint> <rx> <ry> <rz>           local rotation in degrees (unlisted joints = bind)
+//
+// Bind positions are relative to the mesh's AABB so a rig fits any mesh it's loaded
+// against; bind rotations are identity. Joints must be listed parents-first and
+// before the first clip. Durations are positive; key times increase within [0, duration).
+
+static constexpr int MAX_JOINTS = 32; // Also the size of u_Joints in retro.vert
+
+struct Skeleton {
+    std::vector<std::string> names;
+    std::vector<int> parents;
+    std::vector<glm::vec3> bindPositions;  // Model space
+    std::vector<glm::vec3> bindLocal;      // Offset from the parent's bind position
+
+    int joint_count() const { return (int)parents.size(); }
+    int find(const std::string& name) const;
+};
+
+struct AnimClip {
+    std::string name;
+    float duration;
+    std::vector<float> times;
+    std::vector<glm::vec3> rootOffsets;    // One per key
+    std::vector<glm::quat> rotations;      // [key * jointCount + joint]
+};
+
+// Local-space pose: one rotation per joint + the root offset.
+// Lives in an arena (usually the frame arena), sized by the skeleton.
+struct Pose {
+    glm::quat* rotations;
+    glm::vec3 rootOffset;
+};
+
+struct AnimSet {
+    Skeleton skeleton;
+    std::vector<AnimClip> clips;
+
+    int find_clip(const std::string& name) const;
+};
+
+// Parses a .hpanim and fits it to [boundsMin, boundsMax]. name is only used in messages.
+bool load_animation(const char* name, const AssetView& file, const glm::vec3& boundsMin, const glm::vec3& boundsMax, AnimSet& out);
+
+Pose alloc_pose(const Skeleton& skeleton, Arena& arena);
+
+// Samples a looping clip at time t (seconds)
+void sample_clip(const AnimSet& set, const AnimClip& clip, float t, Pose& out);
+
+// out = lerp(a, b, weight), nlerp for rotations. out may alias a.
+void blend_poses(int jointCount, const Pose& a, const Pose& b, float weight, Pose& out);
+
+// Skin matrices (model space * inverse bind) as 3x4 column-major: 4 columns of
+// (x, y, z, 0), translation last. This is the layout skin_vertices() reads.
+void compute_skin_matrices(const Skeleton& skeleton, const Pose& pose, float* out);
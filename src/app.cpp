@@ -1,7 +1,8 @@
 #include "app.hpp"
 #include <iostream>
-#include <fstream>
+#include <iomanip>
 #include <sstream>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -9,8 +10,28 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
+#include "mesh_data.hpp"
+#include "memory_tracker.hpp"
+
+// Level 01: Willow courtyard. UE-style sky face names mapped onto GL cubemap order
+// (+X, -X, +Y, -Y, +Z, -Z); the camera looks down -Z by default, so FR is -Z and BK is +Z.
+static const LevelDesc kLevel01 = {
+    "01",
+    { "../assets/levels/01/Adv1Willow.hpmesh", "../assets/levels/01/Adv1Willow.obj" },
+    "../assets/levels/01/Adv1Willow.lights",
+    {
+        "../assets/levels/01/night_03_RT.png",
+        "../assets/levels/01/night_03_LF.png",
+        "../assets/levels/01/night_03_UP.png",
+        "../assets/levels/01/night_03_DN.png",
+        "../assets/levels/01/night_03_BK.png",
+        "../assets/levels/01/night_03_FR.png",
+    },
+};
+
+// Light counts the F2 stress sweep steps through
+static const int kLightStressCounts[] = { 1, 16, 64, 128, 256, 512, 1024 };
+static const int kLightStressSteps = sizeof(kLightStressCounts) / sizeof(kLightStressCounts[0]);
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
@@ -22,36 +43,25 @@ void error_callback(int error, const char* description) {
 }
 
 unsigned int App::load_texture(const char* path) {
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+    // Encoded bytes come from the pack (or loose file) into staging, released below
+    size_t stagingMark = m_StagingArena.offset;
+    AssetView file;
+    bool found = m_Assets.load(path, m_StagingArena, file);
 
     int width, height, nrComponents;
     // PS1 textures didn't strictly flip, but OpenGL usually expects it.
     stbi_set_flip_vertically_on_load(true);
 
-    unsigned char *data = stbi_load(path, &width, &height, &nrComponents, 0);
+    unsigned int textureID = 0;
+    unsigned char *data = found ? stbi_load_from_memory(file.data, (int)file.size, &width, &height, &nrComponents, 0) : nullptr;
     if (data) {
-        GLenum format;
-        if (nrComponents == 1) format = GL_RED;
-        else if (nrComponents == 3) format = GL_RGB;
-        else if (nrComponents == 4) format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        // PS1 Style: Pixelated textures (Nearest Neighbor)
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-        stbi_image_free(data);
+        textureID = upload_texture(data, width, height, nrComponents, "app");
     } else {
         std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
     }
+    stbi_image_free(data);
 
+    m_StagingArena.offset = stagingMark;
     return textureID;
 }
 
@@ -64,8 +74,24 @@ App::App(const std::string &title, int width, int height)
 }
 
 App::~App() {
-    m_LevelArena.destroy();
+    // Joins a load still in flight before its arena goes away
+    for (Level& level : m_Levels) level.unload();
+
+    m_Jobs.destroy();
+    if (m_HasCrowd) m_Crowd.destroy();
+    glDeleteProgram(m_SkinnedShader);
+    glDeleteProgram(m_BakedShader);
+    m_Skybox.destroy();
+    m_Overlay.destroy();
+    m_LightGrid.destroy();
+    m_Resolution.destroy();
+    m_Assets.close();
+
+    m_AppArena.destroy();
+    m_LevelArenas[0].destroy();
+    m_LevelArenas[1].destroy();
     m_FrameArena.destroy();
+    m_StagingArena.destroy();
 
     if (m_Window) {
         glfwDestroyWindow(m_Window);
@@ -104,24 +130,99 @@ void App::init() {
     }
 
     // --- 3. Initialize Memory Arenas ---
-    // Level Arena: 64MB (Huge block for Mesh, Textures, Sound that stay loaded)
-    m_LevelArena.init(64 * 1024 * 1024);
-    std::cout << "Initialized Level Arena (64MB)" << std::endl;
+    // App Arena: 16MB (floor, crowd, light tables: everything that outlives a level)
+    m_AppArena.init(16 * 1024 * 1024);
+    std::cout << "Initialized App Arena (16MB)" << std::endl;
+
+    // Level Arenas: 2x64MB (the active level, and the next one streaming in behind it)
+    m_LevelArenas[0].init(64 * 1024 * 1024);
+    m_LevelArenas[1].init(64 * 1024 * 1024);
+    std::cout << "Initialized Level Arenas (2x64MB)" << std::endl;
 
     // Frame Arena: 1MB (Scratchpad for per-frame calculations)
     m_FrameArena.init(1 * 1024 * 1024);
     std::cout << "Initialized Frame Arena (1MB)" << std::endl;
 
+    // Staging Arena: 32MB (encoded file bytes on their way to the GPU, rolled back after each load)
+    m_StagingArena.init(32 * 1024 * 1024);
+    std::cout << "Initialized Staging Arena (32MB)" << std::endl;
+
+    // --- Memory budgets ---
+    // Sized for level 01 plus headroom; crossing one logs a [memory] line
+    MemoryTracker& memory = memory_tracker();
+    memory.watch_arena("app", m_AppArena, MEM_ARENA);
+    memory.watch_arena("level0", m_LevelArenas[0], MEM_ARENA);
+    memory.watch_arena("level1", m_LevelArenas[1], MEM_ARENA);
+    memory.watch_arena("frame", m_FrameArena, MEM_ARENA);
+    memory.watch_arena("staging", m_StagingArena, MEM_STAGING);
+    memory.set_budget(MEM_VERTEX, 32 * 1024 * 1024);
+    memory.set_budget(MEM_TEXTURE, 64 * 1024 * 1024);
+    memory.set_budget(MEM_TARGET, 8 * 1024 * 1024);
+    memory.set_budget(MEM_STREAM, 8 * 1024 * 1024);
+    memory.set_budget(MEM_ARENA, 96 * 1024 * 1024);
+    memory.set_budget(MEM_STAGING, 24 * 1024 * 1024);
+
+    // --- Asset Pack ---
+    // Without it everything is read loose from the ../ paths below
+    if (m_Assets.open_pack("level01.hpak")) {
+        std::cout << "Mounted level01.hpak (" << m_Assets.pack.header->entryCount << " files"
+                  << (m_Assets.looseOverride ? ", loose files override" : "") << ")" << std::endl;
+    }
+
     // --- 4. Initialize Subsystems ---
+    m_Jobs.init();
+    std::cout << "Initialized Job System (" << m_Jobs.thread_count() << " threads)" << std::endl;
+
     // m_Renderer = std::make_unique_ptr<Renderer>(); // TODO: Uncomment when Renderer class exists
     // m_Camera = std::make_unique_ptr<Camera>();     // TODO: Uncomment when Camera class exists
 
     m_shader_program = create_shader("../shaders/retro.vert", "../shaders/retro.frag");
+    m_BakedShader = create_shader("../shaders/retro.vert", "../shaders/retro.frag", "#define BAKED_LIGHTING\n");
+    m_SkinnedShader = create_shader("../shaders/retro.vert", "../shaders/retro.frag", "#define SKINNING\n");
 
     m_FloorTexture = load_texture("../textures/zwin_02.png"); // Make sure to create this folder/file!
-    // m_Model = load_model("../assets/levels/01/Adv1Willow.obj");
 
-    m_Model = load_model("../assets/skharrymesh.obj");
+    // Harry: a skinned crowd when the rig loads, the old static model otherwise
+    size_t stagingMark = m_StagingArena.offset;
+    MeshData harryMesh;
+    AssetView harryObj, harryAnim;
+    if (m_Assets.load("../assets/skharrymesh.obj", m_StagingArena, harryObj) &&
+        load_obj_mesh("../assets/skharrymesh.obj", harryObj, asset_loader(), harryMesh) &&
+        m_Assets.load("../assets/skharry.hpanim", m_StagingArena, harryAnim)) {
+        std::string harryDir = mesh_base_dir("../assets/skharrymesh.obj");
+        std::vector<unsigned int> harryTextures;
+        for (const auto& bucket : harryMesh.buckets) {
+            harryTextures.push_back(bucket.texture.empty() ? m_FloorTexture : load_texture((harryDir + bucket.texture).c_str()));
+        }
+        m_HasCrowd = m_Crowd.init(harryMesh, harryTextures, "../assets/skharry.hpanim", harryAnim, m_AppArena);
+    }
+    m_StagingArena.offset = stagingMark;
+    if (!m_HasCrowd) m_Model = load_model("../assets/skharrymesh.obj");
+
+    m_Skybox.init(create_shader("../shaders/skybox.vert", "../shaders/skybox.frag"));
+
+    // --- Lights ---
+    // Slot 0 orbits the scene (dynamic), the rest are the level's static torches,
+    // copied in when the level activates (see apply_level_lights).
+    m_Lights = m_AppArena.alloc_array<PointLight>(MAX_SCENE_LIGHTS);
+    m_LightBaseColors = m_AppArena.alloc_array<glm::vec3>(MAX_SCENE_LIGHTS);
+    m_PrevLightPos = m_AppArena.alloc_array<glm::vec3>(MAX_SCENE_LIGHTS);
+    m_Lights[0] = { glm::vec3(0.0f, 10.0f, 20.0f), 50.0f, glm::vec3(1.0f, 0.8f, 0.6f), 0.0f };
+    m_LightCount = 1;
+    apply_level_lights(nullptr);
+
+    // Stress lights: deterministic scatter over the floor (LCG so runs compare)
+    m_StressLights = m_AppArena.alloc_array<PointLight>(LightGrid::MAX_LIGHTS);
+    m_PrevStressLightPos = m_AppArena.alloc_array<glm::vec3>(LightGrid::MAX_LIGHTS);
+    unsigned int seed = 1234567u;
+    auto rnd = [&seed]() { seed = seed * 1664525u + 1013904223u; return (seed >> 8) / 16777216.0f; };
+    for (int i = 0; i < LightGrid::MAX_LIGHTS; ++i) {
+        m_StressLights[i].position = glm::vec3(rnd() * 100.0f - 50.0f, 1.0f + rnd() * 5.0f, rnd() * 100.0f - 50.0f);
+        m_StressLights[i].range = 4.0f + rnd() * 6.0f;
+        m_StressLights[i].color = glm::vec3(0.5f + rnd() * 0.5f, 0.3f + rnd() * 0.4f, 0.1f + rnd() * 0.3f);
+        m_StressLights[i].isStatic = 0.0f;
+        m_PrevStressLightPos[i] = m_StressLights[i].position;
+    }
 
     float size = 50.0f;
     int gridX = 10;
@@ -132,7 +233,7 @@ void App::init() {
 
     // We need 6 vertices per square * gridX * gridZ * 5 floats per vert
     int floatCount = gridX * gridZ * 6 * 8;
-    float* arenaVertices = m_LevelArena.alloc_array<float>(floatCount);
+    float* arenaVertices = m_AppArena.alloc_array<float>(floatCount);
     int idx = 0;
 
     for (int z = 0; z < gridZ; ++z) {
@@ -190,6 +291,7 @@ void App::init() {
     glBindVertexArray(m_vao);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
     glBufferData(GL_ARRAY_BUFFER, floatCount * sizeof(float), arenaVertices, GL_STATIC_DRAW);
+    memory_tracker().track(MEM_GL_BUFFER, m_vbo, MEM_VERTEX, floatCount * sizeof(float), "app");
 
     int stride = 8 * sizeof(float);
 
@@ -207,34 +309,9 @@ void App::init() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 
-    // --- 5. Setup Framebuffer (The "Virtual Console") ---
-    glGenFramebuffers(1, &m_FBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-
-    // Create a texture to render into (320x240)
-    glGenTextures(1, &m_TexColorBuffer);
-    glBindTexture(GL_TEXTURE_2D, m_TexColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, INTERNAL_WIDTH, INTERNAL_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-
-    // CRITICAL: Use GL_NEAREST for that crunchy pixelated look.
-    // GL_LINEAR would make it blurry (N64 style).
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-    // Attach texture to FBO
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_TexColorBuffer, 0);
-
-    // Create Renderbuffer Object (RBO) for Depth/Stencil (we need depth testing!)
-    glGenRenderbuffers(1, &m_RBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, m_RBO);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, INTERNAL_WIDTH, INTERNAL_HEIGHT);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_RBO);
-
-    // Check if FBO is complete
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cout << "ERROR::FRAMEBUFFER:: Framebuffer is not complete!" << std::endl;
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // Unbind back to default
+    // --- 5. Setup Framebuffers (The "Virtual Console") ---
+    // Every internal resolution up front; the scaler picks one per frame
+    m_Resolution.init();
 
     // --- 6. Setup Screen Quad (The TV Screen) ---
     float quadVertices[] = {
@@ -253,6 +330,7 @@ void App::init() {
     glBindVertexArray(m_ScreenVAO);
     glBindBuffer(GL_ARRAY_BUFFER, m_ScreenVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+    memory_tracker().track(MEM_GL_BUFFER, m_ScreenVBO, MEM_VERTEX, sizeof(quadVertices), "app");
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
@@ -262,18 +340,37 @@ void App::init() {
     // Compile the screen shader
     m_ScreenShader = create_shader("../shaders/screen.vert", "../shaders/screen.frag");
 
+    // Stats overlay (F1), drawn into the FBO pass
+    m_Overlay.init(create_shader("../shaders/overlay.vert", "../shaders/overlay.frag"));
+
+    // Light tiles cover the internal (FBO) resolution, not the window
+    m_LightGrid.init(m_Resolution.target().width, m_Resolution.target().height);
+
+    // --- 7. Frame pacing ---
+    m_PrevCameraPos = m_Camera.Position;
+    apply_frame_settings();
+
+    // --- 8. Level ---
+    // Streams in on a worker; the loop activates it once it's ready
+    request_level(kLevel01);
+
     m_IsRunning = true;
 }
 
 void App::run() {
-    float lastFrame = 0.0f;
+    double lastFrame = glfwGetTime();
+    double accumulator = 0.0;
 
     while (!glfwWindowShouldClose(m_Window) && m_IsRunning) {
         // --- Time Management ---
-        float currentFrame = static_cast<float>(glfwGetTime());
-        float deltaTime = currentFrame - lastFrame;
+        double currentFrame = glfwGetTime();
+        double frameTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // Clamp so a long hitch (window drag, breakpoint) doesn't turn into
+        // hundreds of catch-up ticks
+        accumulator += std::min(frameTime, MAX_FRAME_TIME);
+
         // --- Memory Management ---
         // VITAL: Reset the scratchpad arena every frame.
         // This makes all "temporary" allocations from the previous frame invalid,
@@ -281,13 +378,111 @@ void App::run() {
         m_FrameArena.reset();
 
         // --- The Loop ---
-        process_input(deltaTime);
-        update(deltaTime);
-        render();
+        // Input is sampled once per frame, simulation runs in fixed FIXED_DT ticks,
+        // and render() blends the last two ticks so motion stays smooth at any frame rate.
+        process_input((float)frameTime);
+        update_level_swap();
+        while (accumulator >= FIXED_DT) {
+            save_previous_state();
+            update((float)FIXED_DT);
+            m_SimTime += FIXED_DT;
+            accumulator -= FIXED_DT;
+        }
+        render((float)(accumulator / FIXED_DT));
+
+        update_light_stress((float)frameTime);
+        m_FrameStats.add(frameTime, m_FrameArena);
+        m_LastFrameMs = frameTime * 1000.0;
+        memory_tracker().update();
 
         // --- Window Management ---
         glfwSwapBuffers(m_Window);
         glfwPollEvents();
+        m_FramePacer.wait();
+    }
+}
+
+void App::save_previous_state() {
+    m_PrevCameraPos = m_Camera.Position;
+    for (int i = 0; i < m_LightCount; ++i) {
+        m_PrevLightPos[i] = m_Lights[i].position;
+    }
+    if (m_LightStress.active) {
+        for (int i = 0; i < LightGrid::MAX_LIGHTS; ++i) {
+            m_PrevStressLightPos[i] = m_StressLights[i].position;
+        }
+    }
+}
+
+void App::apply_frame_settings() {
+    glfwSwapInterval(m_FrameSettings.vsync ? 1 : 0);
+    m_FramePacer.set_cap(m_FrameSettings.fpsCap);
+
+    // GPU budget for the resolution scaler: most of the frame period (60Hz when
+    // uncapped), leaving the rest for the CPU side and the swap
+    double periodMs = 1000.0 / (m_FrameSettings.fpsCap > 0 ? m_FrameSettings.fpsCap : 60);
+    m_Resolution.budgetMs = (float)(periodMs * 0.75);
+    std::cout << "[frame] vsync " << (m_FrameSettings.vsync ? "on" : "off")
+              << ", cap " << (m_FrameSettings.fpsCap > 0 ? std::to_string(m_FrameSettings.fpsCap) : std::string("off"))
+              << std::endl;
+}
+
+void App::request_level(const LevelDesc& desc) {
+    if (m_LoadingLevel >= 0) return; // One transition at a time
+
+    // Load into whichever arena the active level isn't using
+    int slot = m_ActiveLevel == 0 ? 1 : 0;
+    m_Levels[slot].unload();
+    m_LoadingLevel = slot;
+    m_SwapStart = glfwGetTime();
+    memory_tracker().set_arena_loading(m_LevelArenas[slot], true);
+    m_Levels[slot].begin_load(desc, slot, m_LevelArenas[slot], m_Assets);
+    std::cout << "[level] loading " << desc.name << " into arena " << slot << std::endl;
+}
+
+void App::update_level_swap() {
+    if (m_LoadingLevel < 0 || !m_Levels[m_LoadingLevel].ready()) return;
+
+    Level& incoming = m_Levels[m_LoadingLevel];
+    int outgoing = m_ActiveLevel;
+    // ready() is the worker's last write: the arena is the main thread's again
+    memory_tracker().set_arena_loading(m_LevelArenas[m_LoadingLevel], false);
+    // Peak is both levels resident: the outgoing one as it stands, the incoming at its load high-water
+    size_t outgoingBytes = outgoing >= 0 ? m_LevelArenas[outgoing].offset : 0;
+    size_t incomingPeak = m_LevelArenas[m_LoadingLevel].peak;
+
+    double uploadStart = glfwGetTime();
+    bool ok = incoming.activate(m_FloorTexture);
+    double uploadMs = (glfwGetTime() - uploadStart) * 1000.0;
+
+    bool leaked = false;
+    if (ok) {
+        if (outgoing >= 0) leaked = !m_Levels[outgoing].unload();
+        m_ActiveLevel = m_LoadingLevel;
+        apply_level_lights(&incoming);
+    } else {
+        leaked = !incoming.unload();
+    }
+    m_LoadingLevel = -1;
+
+    double totalMs = (glfwGetTime() - m_SwapStart) * 1000.0;
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1) << "[level] " << incoming.desc->name << (ok ? " active" : " FAILED")
+         << " in " << totalMs << " ms (worker " << incoming.loadMs << " ms, upload " << uploadMs << " ms)"
+         << std::setprecision(2) << ", peak level memory " << (outgoingBytes + incomingPeak) / (1024.0 * 1024.0)
+         << " MB (" << outgoingBytes / (1024.0 * 1024.0) << " outgoing + " << incomingPeak / (1024.0 * 1024.0)
+         << " incoming)" << (leaked ? ", unload LEAKED GL objects" : "");
+    std::cout << line.str() << std::endl;
+}
+
+void App::apply_level_lights(const Level* level) {
+    // Slot 0 (the orbiting light) is the app's; the rest belong to the level
+    int count = level ? std::min(level->lightCount, MAX_SCENE_LIGHTS - 1) : 0;
+    for (int i = 0; i < count; ++i) m_Lights[1 + i] = level->lights[i];
+    m_LightCount = 1 + count;
+    for (int i = 0; i < m_LightCount; ++i) {
+        m_LightBaseColors[i] = m_Lights[i].color;
+        m_PrevLightPos[i] = m_Lights[i].position;
     }
 }
 
@@ -306,15 +501,109 @@ void App::process_input(float dt) {
         tabPressed = false;
     }
 
-    // Camera WASD
-    if (glfwGetKey(m_Window, GLFW_KEY_W) == GLFW_PRESS)
-        m_Camera.ProcessKeyboard(0, dt);
-    if (glfwGetKey(m_Window, GLFW_KEY_S) == GLFW_PRESS)
-        m_Camera.ProcessKeyboard(1, dt);
-    if (glfwGetKey(m_Window, GLFW_KEY_A) == GLFW_PRESS)
-        m_Camera.ProcessKeyboard(2, dt);
-    if (glfwGetKey(m_Window, GLFW_KEY_D) == GLFW_PRESS)
-        m_Camera.ProcessKeyboard(3, dt);
+    static bool f2Pressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_F2) == GLFW_PRESS && !f2Pressed && !m_LightStress.active) {
+        f2Pressed = true;
+        m_LightStress = {};
+        m_LightStress.active = true;
+        // frame_ms should be the work, not the pacer's sleep or the vsync wait
+        m_LightStress.savedSettings = m_FrameSettings;
+        m_FrameSettings.vsync = false;
+        m_FrameSettings.fpsCap = 0;
+        apply_frame_settings();
+        std::cout << "[lights] Stress sweep started" << std::endl;
+        std::cout << "[lights]  lights   frame_ms   bin_ms   indices" << std::endl;
+    }
+    if (glfwGetKey(m_Window, GLFW_KEY_F2) == GLFW_RELEASE) {
+        f2Pressed = false;
+    }
+
+    // V: vsync, F3: cycle frame cap (both held off while the light sweep runs unpaced)
+    static bool vPressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_V) == GLFW_PRESS && !vPressed && !m_LightStress.active) {
+        vPressed = true;
+        m_FrameSettings.vsync = !m_FrameSettings.vsync;
+        apply_frame_settings();
+    }
+    if (glfwGetKey(m_Window, GLFW_KEY_V) == GLFW_RELEASE) {
+        vPressed = false;
+    }
+
+    static bool f3Pressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_F3) == GLFW_PRESS && !f3Pressed && !m_LightStress.active) {
+        static const int kCaps[] = { 0, 30, 60, 120, 144 };
+        static int capIndex = 0;
+        f3Pressed = true;
+        capIndex = (capIndex + 1) % (sizeof(kCaps) / sizeof(kCaps[0]));
+        m_FrameSettings.fpsCap = kCaps[capIndex];
+        apply_frame_settings();
+    }
+    if (glfwGetKey(m_Window, GLFW_KEY_F3) == GLFW_RELEASE) {
+        f3Pressed = false;
+    }
+
+    // F4: crowd size, F6: CPU/GPU skinning, F7: skinning benchmark
+    static bool f4Pressed = false, f6Pressed = false, f7Pressed = false;
+    if (m_HasCrowd && glfwGetKey(m_Window, GLFW_KEY_F4) == GLFW_PRESS && !f4Pressed) {
+        static const int kCrowdSizes[] = { 1, 16, 64, Crowd::MAX_CHARACTERS };
+        static int sizeIndex = 0;
+        f4Pressed = true;
+        sizeIndex = (sizeIndex + 1) % (sizeof(kCrowdSizes) / sizeof(kCrowdSizes[0]));
+        m_Crowd.characterCount = kCrowdSizes[sizeIndex];
+        std::cout << "[crowd] " << m_Crowd.characterCount << " characters" << std::endl;
+    }
+    if (m_HasCrowd && glfwGetKey(m_Window, GLFW_KEY_F6) == GLFW_PRESS && !f6Pressed) {
+        f6Pressed = true;
+        m_Crowd.gpuSkinning = !m_Crowd.gpuSkinning;
+        std::cout << "[crowd] skinning on the " << (m_Crowd.gpuSkinning ? "GPU (retro.vert)" : "CPU (SSE)") << std::endl;
+    }
+    if (m_HasCrowd && glfwGetKey(m_Window, GLFW_KEY_F7) == GLFW_PRESS && !f7Pressed) {
+        f7Pressed = true;
+        run_skinning_benchmark();
+    }
+    if (glfwGetKey(m_Window, GLFW_KEY_F4) == GLFW_RELEASE) f4Pressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_F6) == GLFW_RELEASE) f6Pressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_F7) == GLFW_RELEASE) f7Pressed = false;
+
+    // F8: resolution mode: auto -> fixed 320x240 -> fixed 640x480 (hi-res) -> auto
+    static bool f8Pressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_F8) == GLFW_PRESS && !f8Pressed) {
+        f8Pressed = true;
+        m_ResolutionMode = (m_ResolutionMode + 1) % 3;
+        if (m_ResolutionMode == 0 && m_Resolution.queriesSupported) {
+            m_Resolution.enabled = true;
+            std::cout << "[resolution] auto (budget " << m_Resolution.budgetMs << " ms)" << std::endl;
+            if (m_Resolution.current > m_Resolution.maxTarget) m_Resolution.set_target(m_Resolution.maxTarget, "auto cap");
+        } else {
+            if (m_ResolutionMode == 0) m_ResolutionMode = 1; // No timer queries: auto isn't an option
+            m_Resolution.enabled = false;
+            int index = m_ResolutionMode == 1 ? ResolutionScaler::DEFAULT_TARGET : ResolutionScaler::TARGET_COUNT - 1;
+            m_Resolution.set_target(index, "manual");
+        }
+    }
+    if (glfwGetKey(m_Window, GLFW_KEY_F8) == GLFW_RELEASE) f8Pressed = false;
+
+    // F1: stats overlay (memory, draw calls, frame timings)
+    static bool f1Pressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_F1) == GLFW_PRESS && !f1Pressed) {
+        f1Pressed = true;
+        m_Overlay.visible = !m_Overlay.visible;
+    }
+    if (glfwGetKey(m_Window, GLFW_KEY_F1) == GLFW_RELEASE) f1Pressed = false;
+
+    // F5: hot-reload the level (streams into the other arena, swaps when ready)
+    static bool f5Pressed = false;
+    if (glfwGetKey(m_Window, GLFW_KEY_F5) == GLFW_PRESS && !f5Pressed) {
+        f5Pressed = true;
+        if (m_ActiveLevel >= 0) request_level(*m_Levels[m_ActiveLevel].desc);
+    }
+    if (glfwGetKey(m_Window, GLFW_KEY_F5) == GLFW_RELEASE) f5Pressed = false;
+
+    // Camera WASD: just sampled here, update() integrates it at the fixed rate
+    m_Input.forward  = glfwGetKey(m_Window, GLFW_KEY_W) == GLFW_PRESS;
+    m_Input.backward = glfwGetKey(m_Window, GLFW_KEY_S) == GLFW_PRESS;
+    m_Input.left     = glfwGetKey(m_Window, GLFW_KEY_A) == GLFW_PRESS;
+    m_Input.right    = glfwGetKey(m_Window, GLFW_KEY_D) == GLFW_PRESS;
 
     if (glfwGetInputMode(m_Window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED) {
         double xpos, ypos;
@@ -333,6 +622,7 @@ void App::process_input(float dt) {
         m_LastY = ypos;
 
         // Pass to Camera (ensure you have m_Camera implemented)
+        // Mouse look stays per-frame: it's a direct mapping, not integrated over time
         m_Camera.ProcessMouseMovement(xoffset, yoffset);
     }
 }
@@ -340,50 +630,194 @@ void App::process_input(float dt) {
 void App::update(float dt) {
     // Game Logic goes here
     // e.g. m_Camera->update(m_State.playerX, m_State.playerY...);
+    if (m_Input.forward)  m_Camera.ProcessKeyboard(0, dt);
+    if (m_Input.backward) m_Camera.ProcessKeyboard(1, dt);
+    if (m_Input.left)     m_Camera.ProcessKeyboard(2, dt);
+    if (m_Input.right)    m_Camera.ProcessKeyboard(3, dt);
+
+    update_lights((float)m_SimTime);
+}
+
+void App::run_skinning_benchmark() {
+    static const int kCounts[] = { 1, 16, 64, Crowd::MAX_CHARACTERS };
+    static const int kWarmup = 3;
+    static const int kIterations = 20;
+
+    int savedCount = m_Crowd.characterCount;
+    bool savedScalar = m_Crowd.scalarSkinning;
+
+    // Off the GL path entirely: skin into plain memory
+    Arena scratch;
+    scratch.init(8 * 1024 * 1024);
+    std::vector<float> out((size_t)Crowd::MAX_CHARACTERS * m_Crowd.vertexCount * SKINNED_FLOATS);
+
+    std::cout << "[skinning] " << m_Crowd.vertexCount << " verts, " << m_Crowd.anim.skeleton.joint_count()
+              << " joints, " << m_Jobs.thread_count() << " threads" << std::endl;
+    std::cout << "[skinning]  chars    simd_ms  chars/ms  scalar_ms  chars/ms" << std::endl;
+
+    for (int count : kCounts) {
+        double ms[2];
+        for (int scalar = 0; scalar < 2; ++scalar) {
+            m_Crowd.characterCount = count;
+            m_Crowd.scalarSkinning = scalar == 1;
+            for (int i = 0; i < kWarmup + kIterations; ++i) {
+                if (i == kWarmup) ms[scalar] = glfwGetTime();
+                scratch.reset();
+                m_Crowd.simulate(i * 0.016f, m_Jobs, scratch, out.data());
+            }
+            ms[scalar] = (glfwGetTime() - ms[scalar]) * 1000.0 / kIterations;
+        }
+        std::ostringstream line;
+        line << std::fixed << "[skinning] " << std::setw(6) << count
+             << std::setprecision(3) << std::setw(11) << ms[0] << std::setprecision(1) << std::setw(10) << count / ms[0]
+             << std::setprecision(3) << std::setw(11) << ms[1] << std::setprecision(1) << std::setw(10) << count / ms[1];
+        std::cout << line.str() << std::endl;
+    }
+
+    scratch.destroy();
+    m_Crowd.characterCount = savedCount;
+    m_Crowd.scalarSkinning = savedScalar;
+}
+
+void App::update_lights(float time) {
+    // Make a light orbit the scene
+    m_Lights[0].position = glm::vec3(sin(time) * 20.0f, 10.0f, cos(time) * 20.0f);
+
+    // Torches: cheap flicker (baked geometry keeps the unflickered bake)
+    for (int i = 1; i < m_LightCount; ++i) {
+        float flicker = 0.85f + 0.15f * sin(time * 13.0f + i * 7.1f) * sin(time * 7.3f + i);
+        m_Lights[i].color = m_LightBaseColors[i] * flicker;
+    }
+
+    // Stress lights bob so binning has to redo work every frame
+    if (m_LightStress.active) {
+        for (int i = 0; i < LightGrid::MAX_LIGHTS; ++i) {
+            m_StressLights[i].position.y = 3.5f + sin(time * 2.0f + i * 0.37f) * 2.5f;
+        }
+    }
 }
 
-void App::render() {
+void App::update_light_stress(float dt) {
+    static const int kWarmupFrames = 30;
+    static const int kMeasuredFrames = 240;
+
+    if (!m_LightStress.active) return;
+
+    LightStress& s = m_LightStress;
+    s.frame++;
+    if (s.frame > kWarmupFrames) {
+        s.frameMs += dt * 1000.0;
+        s.binMs += s.lastBinMs;
+        s.indices += m_LightGrid.indexCount;
+    }
+    if (s.frame < kWarmupFrames + kMeasuredFrames) return;
+
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3) << "[lights] " << std::setw(7) << kLightStressCounts[s.step]
+         << std::setw(11) << s.frameMs / kMeasuredFrames << std::setw(9) << s.binMs / kMeasuredFrames
+         << std::setprecision(0) << std::setw(10) << s.indices / kMeasuredFrames;
+    std::cout << line.str() << std::endl;
+
+    s.step++;
+    s.frame = 0;
+    s.frameMs = s.binMs = s.indices = 0.0;
+    if (s.step == kLightStressSteps) {
+        s.active = false;
+        std::cout << "[lights] Stress sweep done" << std::endl;
+        m_FrameSettings = s.savedSettings;
+        apply_frame_settings();
+    }
+}
+
+void App::render(float alpha) {
+    m_Resolution.begin_frame();
+
+    // Whatever size the scaler settled on; snapping, light tiles and the
+    // viewport all follow it so the pixel grid stays consistent
+    const RenderTarget& target = m_Resolution.target();
+    if (m_LightGrid.width != target.width || m_LightGrid.height != target.height) {
+        m_LightGrid.resize(target.width, target.height);
+    }
+
     // =========================================================
-    // PASS 1: Render the GAME to the tiny FBO (320x240)
+    // PASS 1: Render the GAME to the tiny FBO (320x240 by default)
     // =========================================================
-    glBindFramebuffer(GL_FRAMEBUFFER, m_FBO);
-    glViewport(0, 0, INTERNAL_WIDTH, INTERNAL_HEIGHT);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+    glViewport(0, 0, target.width, target.height);
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glEnable(GL_DEPTH_TEST);
 
-    glUseProgram(m_shader_program);
+    // --- GLOBAL UNIFORMS (View/Projection apply to everything) ---
+    float aspectRatio = (float)target.width / (float)target.height;
+    float nearPlane = 0.1f;
+    glm::mat4 projection = glm::perspective(glm::radians(m_Camera.Zoom), aspectRatio, nearPlane, 1000.0f);
+
+    // Interpolate between the last two simulation ticks
+    Camera renderCamera = m_Camera;
+    renderCamera.Position = glm::mix(m_PrevCameraPos, m_Camera.Position, alpha);
+    glm::mat4 view = renderCamera.GetViewMatrix();
+
+    // --- LIGHTS: bin into screen tiles (scratch lives in the frame arena) ---
+    const PointLight* simLights = m_Lights;
+    const glm::vec3* prevPositions = m_PrevLightPos;
+    int lightCount = m_LightCount;
+    if (m_LightStress.active) {
+        simLights = m_StressLights;
+        prevPositions = m_PrevStressLightPos;
+        lightCount = kLightStressCounts[m_LightStress.step];
+    }
 
-    unsigned int lightPosLoc   = glGetUniformLocation(m_shader_program, "u_LightPos");
-    unsigned int lightColorLoc = glGetUniformLocation(m_shader_program, "u_LightColor");
-    unsigned int rangeLoc      = glGetUniformLocation(m_shader_program, "u_LightRange");
-    unsigned int ambientLoc    = glGetUniformLocation(m_shader_program, "u_AmbientColor");
+    PointLight* lights = m_FrameArena.alloc_array<PointLight>(lightCount);
+    for (int i = 0; i < lightCount; ++i) {
+        lights[i] = simLights[i];
+        lights[i].position = glm::mix(prevPositions[i], simLights[i].position, alpha);
+    }
 
-    // Make a light orbit the scene
-    float time = (float)glfwGetTime();
-    float lightX = sin(time) * 20.0f;
-    float lightZ = cos(time) * 20.0f;
+    int drawCalls = 0;
 
-    glUniform3f(lightPosLoc, lightX, 10.0f, lightZ); // Light at height 10
-    glUniform3f(lightColorLoc, 1.0f, 0.8f, 0.6f);    // Warm torch color
-    glUniform1f(rangeLoc, 50.0f);                    // 50 unit radius
-    glUniform3f(ambientLoc, 0.2f, 0.2f, 0.3f);       // Dark blue ambient
+    double binStart = glfwGetTime();
+    m_LightGrid.build(lights, lightCount, view, projection, nearPlane, m_FrameArena);
+    m_LightStress.lastBinMs = (glfwGetTime() - binStart) * 1000.0;
 
-    // --- GLOBAL UNIFORMS (View/Projection apply to everything) ---
-    float aspectRatio = (float)INTERNAL_WIDTH / (float)INTERNAL_HEIGHT;
-    glm::mat4 projection = glm::perspective(glm::radians(m_Camera.Zoom), aspectRatio, 0.1f, 1000.0f);
-    glm::mat4 view = m_Camera.GetViewMatrix();
+    // Shared setup for retro.frag and its BAKED_LIGHTING variant
+    auto use_world_program = [&](unsigned int program) {
+        glUseProgram(program);
+        glUniform3fv(glGetUniformLocation(program, "u_AmbientColor"), 1, glm::value_ptr(AMBIENT_COLOR));
+        glUniformMatrix4fv(glGetUniformLocation(program, "view"), 1, GL_FALSE, glm::value_ptr(view));
+        glUniformMatrix4fv(glGetUniformLocation(program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+        glUniform2f(glGetUniformLocation(program, "u_SnapResolution"), (float)target.width, (float)target.height);
+        glUniform1i(glGetUniformLocation(program, "u_Texture"), 0);
+
+        // Texture units 1..3 (0 stays the diffuse texture)
+        m_LightGrid.bind(program, 1);
+    };
+
+    // =========================================================
+    // PART 0: DRAW THE LEVEL (Static, baked lighting when available)
+    // =========================================================
+    const Level* level = m_ActiveLevel >= 0 ? &m_Levels[m_ActiveLevel] : nullptr;
+    if (level && !level->model.empty()) {
+        unsigned int levelProgram = level->model[0].baked ? m_BakedShader : m_shader_program;
+        use_world_program(levelProgram);
+
+        glm::mat4 levelModel = glm::mat4(1.0f);
+        glUniformMatrix4fv(glGetUniformLocation(levelProgram, "model"), 1, GL_FALSE, glm::value_ptr(levelModel));
+
+        for (const auto& mesh : level->model) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, mesh.textureID);
+            glBindVertexArray(mesh.vao);
+            glDrawArrays(GL_TRIANGLES, 0, mesh.vertexCount);
+        }
+        drawCalls += (int)level->model.size();
+    }
+
+    use_world_program(m_shader_program);
 
     unsigned int modelLoc = glGetUniformLocation(m_shader_program, "model");
-    unsigned int viewLoc  = glGetUniformLocation(m_shader_program, "view");
-    unsigned int projLoc  = glGetUniformLocation(m_shader_program, "projection");
-    unsigned int snapLoc  = glGetUniformLocation(m_shader_program, "u_SnapResolution");
     unsigned int texLoc   = glGetUniformLocation(m_shader_program, "u_Texture");
 
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-    glUniform2f(snapLoc, INTERNAL_WIDTH / 1.0f, (float)INTERNAL_HEIGHT / 1.0f);
-
     // =========================================================
     // PART 1: DRAW THE FLOOR (Static)
     // =========================================================
@@ -399,27 +833,52 @@ void App::render() {
     // 3. Draw Floor VAO
     glBindVertexArray(m_vao);
     glDrawArrays(GL_TRIANGLES, 0, m_FloorVertexCount);
+    drawCalls++;
 
     // =========================================================
-    // PART 2: DRAW THE CHARACTER (Rotating)
+    // PART 2: DRAW THE CHARACTERS (Skinned crowd)
     // =========================================================
-    // 1. Calculate Character Transform
-    glm::mat4 charModel = glm::mat4(1.0f);
-    charModel = glm::translate(charModel, glm::vec3(0.0f, 0.0f, 0.0f)); // Optional: Adjust height
-    charModel = glm::scale(charModel, glm::vec3(0.1f));                 // Scale down 10x
-   //charModel = glm::rotate(charModel, (float)glfwGetTime(), glm::vec3(0.0f, 1.0f, 0.0f)); // Spin
-
-    // 2. Update Uniform (Crucial Step: This overrides the floor's matrix)
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(charModel));
+    // Animation time is interpolated between sim ticks like everything else
+    float animTime = (float)(m_SimTime - FIXED_DT + alpha * FIXED_DT);
+    if (m_HasCrowd && m_Crowd.update(animTime, m_Jobs, m_FrameArena)) {
+        unsigned int crowdProgram = m_Crowd.gpuSkinning ? m_SkinnedShader : m_shader_program;
+        if (crowdProgram != m_shader_program) use_world_program(crowdProgram);
+        m_Crowd.draw(crowdProgram);
+        drawCalls += m_Crowd.characterCount * (int)m_Crowd.parts.size();
+    } else {
+        // 1. Calculate Character Transform
+        glm::mat4 charModel = glm::mat4(1.0f);
+        charModel = glm::translate(charModel, glm::vec3(0.0f, 0.0f, 0.0f)); // Optional: Adjust height
+        charModel = glm::scale(charModel, glm::vec3(0.1f));                 // Scale down 10x
+
+        // 2. Update Uniform (Crucial Step: This overrides the floor's matrix)
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(charModel));
+
+        // 3. Draw Character Submeshes
+        for (const auto& mesh : m_Model) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, mesh.textureID);
+            glUniform1i(texLoc, 0);
+
+            glBindVertexArray(mesh.vao);
+            glDrawArrays(GL_TRIANGLES, 0, mesh.vertexCount);
+        }
+        drawCalls += (int)m_Model.size();
+    }
 
-    // 3. Draw Character Submeshes
-    for (const auto& mesh : m_Model) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, mesh.textureID);
-        glUniform1i(texLoc, 0);
+    // =========================================================
+    // PART 3: DRAW THE SKY (Last, so depth rejects covered pixels)
+    // =========================================================
+    if (level && level->cubemap) {
+        m_Skybox.draw(level->cubemap, view, projection, (float)target.width, (float)target.height);
+        drawCalls++;
+    }
 
-        glBindVertexArray(mesh.vao);
-        glDrawArrays(GL_TRIANGLES, 0, mesh.vertexCount);
+    // =========================================================
+    // PART 4: STATS OVERLAY (F1, on top of everything at internal resolution)
+    // =========================================================
+    if (m_Overlay.visible) {
+        draw_overlay(target, drawCalls + 2); // + the overlay itself and the screen pass
     }
 
     // =========================================================
@@ -435,34 +894,76 @@ void App::render() {
 
     glUseProgram(m_ScreenShader);
     glBindVertexArray(m_ScreenVAO);
-    glBindTexture(GL_TEXTURE_2D, m_TexColorBuffer);
+    glBindTexture(GL_TEXTURE_2D, target.color);
     glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    m_Resolution.end_frame();
+}
+
+void App::draw_overlay(const RenderTarget& target, int drawCalls) {
+    const MemoryTracker& memory = memory_tracker();
+    auto mb = [](size_t bytes) { return bytes / (1024.0 * 1024.0); };
+    const int x = 2;
+    const int lineHeight = StatsOverlay::CELL_H + 1;
+    int y = 2;
+
+    // Text and vertices go in the frame arena, gone at the next reset
+    m_Overlay.begin(m_FrameArena);
+
+    // --- Frame ---
+    double fps = m_FrameStats.meanMs > 0.0 ? 1000.0 / m_FrameStats.meanMs : 0.0;
+    m_Overlay.print(x, y, "FPS %.0f  %.2f MS  AVG %.2f P99 %.2f", fps, m_LastFrameMs, m_FrameStats.meanMs, m_FrameStats.p99Ms);
+    y += lineHeight;
+    m_Overlay.print(x, y, "GPU %.2f MS  %dX%d  DRAWS %d", m_Resolution.gpuMs, target.width, target.height, drawCalls);
+    y += lineHeight;
+
+    // --- Memory per category: now, high-water, budget (! = over budget) ---
+    for (int c = 0; c < MEM_CATEGORY_COUNT; ++c) {
+        m_Overlay.print(x, y, "%-8s%6.2f PK %6.2f /%5.1f MB%s", mem_category_name((MemCategory)c), mb(memory.bytes[c]),
+                        mb(memory.peak[c]), mb(memory.budget[c]), memory.overBudget[c] ? " !" : "");
+        y += lineHeight;
+    }
+
+    // Textures by owner: the app's, and each loaded level's
+    m_Overlay.print(x, y, " TEX APP %.2f MB", mb(memory.owner_bytes("app", MEM_TEXTURE)));
+    y += lineHeight;
+    for (const Level& level : m_Levels) {
+        if (!level.desc) continue;
+        m_Overlay.print(x, y, " TEX LEVEL %s %.2f MB", level.owner, mb(memory.owner_bytes(level.owner, MEM_TEXTURE)));
+        y += lineHeight;
+    }
+
+    // Arena fill: in use and high-water as of the end of last frame, out of the reserve
+    for (const MemoryTracker::WatchedArena& watched : memory.arenas) {
+        m_Overlay.print(x, y, " %-7s%6.2f PK %6.2f /%5.1f MB%s", watched.name, mb(watched.used), mb(watched.peak),
+                        mb(watched.arena->size), watched.loading ? " LOADING" : "");
+        y += lineHeight;
+    }
+
+    m_Overlay.draw(target.width, target.height);
 }
 
-unsigned int App::create_shader(const char* vertexPath, const char* fragmentPath) {
-    // 1. Retrieve the vertex/fragment source code from filePath
+unsigned int App::create_shader(const char* vertexPath, const char* fragmentPath, const char* defines) {
+    // 1. Retrieve the vertex/fragment source code (pack or loose file)
     std::string vertexCode;
     std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
-
-    // Ensure ifstream objects can throw exceptions:
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-    try {
-        // Open files (adjust paths if you run from different dirs)
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-        std::stringstream vShaderStream, fShaderStream;
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        vShaderFile.close();
-        fShaderFile.close();
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    } catch (std::ifstream::failure& e) {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << e.what() << std::endl;
+    size_t stagingMark = m_StagingArena.offset;
+    AssetView vShaderFile, fShaderFile;
+    if (m_Assets.load(vertexPath, m_StagingArena, vShaderFile) &&
+        m_Assets.load(fragmentPath, m_StagingArena, fShaderFile)) {
+        vertexCode.assign((const char*)vShaderFile.data, vShaderFile.size);
+        fragmentCode.assign((const char*)fShaderFile.data, fShaderFile.size);
+    } else {
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << vertexPath << ", " << fragmentPath << std::endl;
+    }
+    m_StagingArena.offset = stagingMark;
+
+    // Variants: splice the defines in right after the #version line
+    if (defines) {
+        for (std::string* code : { &vertexCode, &fragmentCode }) {
+            size_t lineEnd = code->find('\n');
+            if (lineEnd != std::string::npos) code->insert(lineEnd + 1, defines);
+        }
     }
 
     const char* vShaderCode = vertexCode.c_str();
@@ -509,126 +1010,38 @@ unsigned int App::create_shader(const char* vertexPath, const char* fragmentPath
     return ID;
 }
 
-App::Model App::load_model(const char* objPath) {
-    Model model; // The list of sub-meshes we will return
-
-    // 1. TinyObj Loader Variables
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    // Get the base directory of the OBJ so we can find textures next to it
-    std::string baseDir = objPath;
-    if (baseDir.find_last_of("/\\") != std::string::npos) {
-        baseDir = baseDir.substr(0, baseDir.find_last_of("/\\") + 1);
-    } else {
-        baseDir = "";
-    }
+MeshFileLoader App::asset_loader() {
+    // MTLs are read next to their OBJ, into staging (the caller rolls it back)
+    return [this](const std::string& path, AssetView& out) {
+        return m_Assets.load(path.c_str(), m_StagingArena, out);
+    };
+}
 
-    // 2. Load the OBJ and the MTL
-    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath, baseDir.c_str());
+App::Model App::load_model(const char* path) {
+    Model model; // The list of sub-meshes we will return
 
-    if (!warn.empty()) std::cout << "OBJ Warning: " << warn << std::endl;
-    if (!err.empty()) std::cerr << "OBJ Error: " << err << std::endl;
+    // 1. Parse into CPU-side buckets (baked .hpmesh from hp3d_bake, or a raw OBJ)
+    // The file bytes only live in staging while parsing, the buckets own their vertices
+    MeshData mesh;
+    std::string pathStr = path;
+    bool isBaked = pathStr.size() > 7 && pathStr.compare(pathStr.size() - 7, 7, ".hpmesh") == 0;
+    size_t stagingMark = m_StagingArena.offset;
+    AssetView file;
+    bool ret = m_Assets.load(path, m_StagingArena, file) &&
+               (isBaked ? load_baked_mesh(path, file, mesh) : load_obj_mesh(path, file, asset_loader(), mesh));
+    m_StagingArena.offset = stagingMark;
     if (!ret) return model;
 
-    // 3. Group Geometry by Material
-    // Map: Material Index -> List of Floats (Vertex Data)
-    // We use a map so we can blindly throw triangles into buckets
-    std::map<int, std::vector<float>> sortedGeometry;
-
-    // Loop over all shapes (objects in the file)
-    for (const auto& shape : shapes) {
-        // Loop over all faces (triangles)
-        size_t index_offset = 0;
-        for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++) {
-
-            // Get the material ID for this specific face
-            int currentMaterialId = shape.mesh.material_ids[f];
-
-            // If the mesh has no material (-1), group it into a default bucket (0)
-            if (currentMaterialId < 0) currentMaterialId = 0;
-
-            // Get the 3 vertices of this face
-            for (size_t v = 0; v < 3; v++) {
-                tinyobj::index_t idx = shape.mesh.indices[index_offset + v];
-
-                // --- POSITIONS ---
-                sortedGeometry[currentMaterialId].push_back(attrib.vertices[3 * idx.vertex_index + 0]);
-                sortedGeometry[currentMaterialId].push_back(attrib.vertices[3 * idx.vertex_index + 1]);
-                sortedGeometry[currentMaterialId].push_back(attrib.vertices[3 * idx.vertex_index + 2]);
-
-                // --- TEXCOORDS ---
-                if (idx.texcoord_index >= 0) {
-                    sortedGeometry[currentMaterialId].push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
-                    sortedGeometry[currentMaterialId].push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
-                } else {
-                    sortedGeometry[currentMaterialId].push_back(0.0f);
-                    sortedGeometry[currentMaterialId].push_back(0.0f);
-                }
-
-                if (idx.normal_index >= 0) {
-                    sortedGeometry[currentMaterialId].push_back(attrib.normals[3 * idx.normal_index + 0]);
-                    sortedGeometry[currentMaterialId].push_back(attrib.normals[3 * idx.normal_index + 1]);
-                    sortedGeometry[currentMaterialId].push_back(attrib.normals[3 * idx.normal_index + 2]);
-                } else {
-                    // Fallback if OBJ has no normals (Up vector)
-                    sortedGeometry[currentMaterialId].push_back(0.0f);
-                    sortedGeometry[currentMaterialId].push_back(1.0f);
-                    sortedGeometry[currentMaterialId].push_back(0.0f);
-                }
-            }
-            index_offset += 3;
-        }
-    }
-
-    // 4. Create a SubMesh for each material group
-    for (auto& [matID, data] : sortedGeometry) {
-        SubMesh subMesh = {};
-
-        // A. Load the Texture for this group
-        if (matID < materials.size() && !materials[matID].diffuse_texname.empty()) {
-            std::string texPath = baseDir + materials[matID].diffuse_texname;
-            // Check if we already loaded this texture? (Optimization for later)
-            subMesh.textureID = load_texture(texPath.c_str());
-        } else {
-            // Fallback texture if none specified in MTL
-            subMesh.textureID = m_FloorTexture;
-        }
-
-        // B. Create VAO/VBO
-        subMesh.vertexCount = data.size() / 5;
+    // Textures live next to the mesh
+    std::string baseDir = mesh_base_dir(path);
 
-        // Copy to Arena
-        float* arenaBuffer = m_LevelArena.alloc_array<float>(data.size());
-        memcpy(arenaBuffer, data.data(), data.size() * sizeof(float));
-
-        glGenVertexArrays(1, &subMesh.vao);
-        glGenBuffers(1, &subMesh.vbo);
-        glBindVertexArray(subMesh.vao);
-        glBindBuffer(GL_ARRAY_BUFFER, subMesh.vbo);
-        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), arenaBuffer, GL_STATIC_DRAW);
-
-        int stride = 8 * sizeof(float);
-
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-
-        // 2. Tex (Location 1) - Offset 3 floats
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-
-        // 3. Normals (Location 2) - Offset 5 floats
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(5 * sizeof(float)));
-
-        glBindVertexArray(0);
-
-        // Add to our list
-        model.push_back(subMesh);
+    // 2. Create a SubMesh for each material group
+    for (const auto& bucket : mesh.buckets) {
+        // Fallback texture if none specified in MTL
+        unsigned int textureID = bucket.texture.empty() ? m_FloorTexture : load_texture((baseDir + bucket.texture).c_str());
+        model.push_back(upload_submesh(bucket.vertices.data(), bucket.vertices.size(), mesh.stride, textureID, "app"));
     }
 
-    std::cout << "Loaded Model with " << model.size() << " sub-meshes." << std::endl;
+    std::cout << "Loaded Model with " << model.size() << " sub-meshes" << (isBaked ? " (baked)." : ".") << std::endl;
     return model;
-}
\ No newline at end of file
+}
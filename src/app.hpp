@@ -4,10 +4,21 @@
 #include <GLFW/glfw3.h>
 #include <memory>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 #include "arena.hpp"
+#include "asset_pack.hpp"
 #include "camera.hpp"
+#include "crowd.hpp"
+#include "frame_pacer.hpp"
+#include "job_system.hpp"
+#include "level.hpp"
+#include "lights.hpp"
+#include "resolution.hpp"
+#include "mesh_data.hpp"
+#include "overlay.hpp"
+#include "skybox.hpp"
 
 // class Renderer;
 // class Camera;
@@ -20,21 +31,23 @@ public:
 
     void run();
 
-    struct SubMesh {
-        unsigned int vao;
-        unsigned int vbo;
-        unsigned int textureID;
-        int vertexCount;
-    };
-
-    // A "Model" is just a list of parts
+    // A "Model" is just a list of parts (SubMesh lives in level.hpp)
     using Model = std::vector<SubMesh>;
 
 private:
     void init();
     void update(float dt);
-    void render();
+    void render(float alpha);   // alpha: how far we are between the last two sim ticks
     void process_input(float dt);
+    void save_previous_state();
+    void apply_frame_settings();
+    void run_skinning_benchmark();
+    void update_lights(float time);
+    void update_light_stress(float dt);
+    void request_level(const LevelDesc& desc);
+    void update_level_swap();
+    void apply_level_lights(const Level* level);
+    void draw_overlay(const RenderTarget& target, int drawCalls);
 
     GLFWwindow* m_Window;
     int m_Width;
@@ -52,28 +65,58 @@ private:
         float playerZ = 0.0f;
     } g;
 
+    // Held movement keys, sampled per frame and consumed by the fixed update
+    struct Input {
+        bool forward = false;
+        bool backward = false;
+        bool left = false;
+        bool right = false;
+    } m_Input;
+
+    // ====== TIMING
+    static constexpr double FIXED_DT = 1.0 / 60.0;     // Simulation rate
+    static constexpr double MAX_FRAME_TIME = 0.25;     // Longest frame we try to catch up on
+
+    double m_SimTime = 0.0;
+    glm::vec3 m_PrevCameraPos;  // Camera position at the previous tick (render interpolates)
+
+    struct FrameSettings {
+        bool vsync = true;
+        int fpsCap = 0;         // 0 = uncapped (vsync still applies)
+    } m_FrameSettings;
+
+    FramePacer m_FramePacer;
+    FrameStats m_FrameStats;
+    double m_LastFrameMs = 0.0;
+
     // ====== ARENAS
-    Arena m_LevelArena;
+    Arena m_AppArena;           // Lives as long as the App
+    Arena m_LevelArenas[2];     // Double-buffered: one per Level slot
     Arena m_FrameArena;
+    Arena m_StagingArena;   // File bytes while loading, rolled back to a mark after each asset
+
+    // ====== ASSETS
+    AssetSource m_Assets;   // level01.hpak, or loose files
 
-    unsigned int create_shader(const char* vertex_path, const char* frag_path);
+    // defines (optional) are spliced in after #version, e.g. "#define BAKED_LIGHTING\n"
+    unsigned int create_shader(const char* vertex_path, const char* frag_path, const char* defines = nullptr);
     unsigned int load_texture(const char* path);
     unsigned int m_shader_program;
+    unsigned int m_BakedShader; // retro.frag with BAKED_LIGHTING
+    unsigned int m_SkinnedShader; // retro.vert with SKINNING
     unsigned int m_vao, m_vbo;
     int m_FloorVertexCount;
 
-    // FBO Stuff
-    unsigned int m_FBO;         // The Framebuffer Object
-    unsigned int m_TexColorBuffer; // The Texture we render to
-    unsigned int m_RBO;         // The Depth Buffer for the FBO
+    // FBO Stuff: one preallocated target per internal resolution
+    ResolutionScaler m_Resolution;
+    int m_ResolutionMode = 0;   // F8: 0 auto, 1 fixed 320x240, 2 fixed 640x480
 
     // Screen Quad Stuff
     unsigned int m_ScreenVAO, m_ScreenVBO;
     unsigned int m_ScreenShader; // The compiled screen.vert/frag
 
-    // Settings
-    const int INTERNAL_WIDTH = 320;
-    const int INTERNAL_HEIGHT = 240;
+    // F1: memory, draw calls and frame timings, drawn into the FBO pass
+    StatsOverlay m_Overlay;
 
     // Camera System
     Camera m_Camera;
@@ -84,7 +127,47 @@ private:
 
     unsigned int m_FloorTexture;
 
-    Model load_model(const char* objPath);
+    // Sky (the level's cubemap, drawn last in the FBO pass)
+    Skybox m_Skybox;
+
+    // Levels: m_Levels[i] loads into m_LevelArenas[i]. -1 = none.
+    Level m_Levels[2];
+    int m_ActiveLevel = -1;
+    int m_LoadingLevel = -1;
+    double m_SwapStart = 0.0;   // glfwGetTime() when the current transition was requested
+
+    // Lights (binned into screen tiles every frame, see LightGrid)
+    LightGrid m_LightGrid;
+    static constexpr int MAX_SCENE_LIGHTS = 256;
+    PointLight* m_Lights;        // Scene lights: the orbiting light + the active level's torches
+    glm::vec3* m_LightBaseColors; // Unflickered colors
+    glm::vec3* m_PrevLightPos;    // Previous tick positions, for render interpolation
+    int m_LightCount;
+    PointLight* m_StressLights;  // LightGrid::MAX_LIGHTS scattered lights for the stress sweep
+    glm::vec3* m_PrevStressLightPos;
+
+    // F2: sweep the light count and report frame time per step
+    struct LightStress {
+        bool active = false;
+        int step = 0;
+        int frame = 0;
+        double frameMs = 0.0;   // Accumulated over the measured frames of this step
+        double binMs = 0.0;
+        double indices = 0.0;
+        double lastBinMs = 0.0; // Written by render()
+        FrameSettings savedSettings;    // The sweep runs with vsync and the cap off, restored after
+    } m_LightStress;
+
+    // Loads an OBJ or a baked .hpmesh
+    Model load_model(const char* path);
+    MeshFileLoader asset_loader();
+
+    // Worker threads for per-frame data-parallel work
+    JobSystem m_Jobs;
+
+    // Animated characters (falls back to the static m_Model without a rig)
+    Crowd m_Crowd;
+    bool m_HasCrowd = false;
 
     // The loaded model
     Model m_Model;
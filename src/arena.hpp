@@ -9,11 +9,13 @@ struct Arena {
     unsigned char* buffer;
     size_t size;
     size_t offset;
+    size_t peak;    // High-water mark of offset since init (or the last reset_peak)
 
     void init(size_t size_in_bytes) {
         size = size_in_bytes;
         buffer = (unsigned char*)malloc(size);
         offset = 0;
+        peak = 0;
     }
 
     void destroy() {
@@ -33,6 +35,7 @@ struct Arena {
         offset += padding;
         void* ptr = &buffer[offset];
         offset += size_to_alloc;
+        if (offset > peak) peak = offset;
 
         return ptr;
     }
@@ -41,6 +44,10 @@ struct Arena {
         offset = 0;
     }
 
+    void reset_peak() {
+        peak = offset;
+    }
+
     template<typename T>
     T* alloc() {
         return (T*)alloc(sizeof(T));
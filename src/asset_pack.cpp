@@ -0,0 +1,260 @@
+#include "asset_pack.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "lz4.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+
+std::string pack_normalize_path(const char* path) {
+    std::string p = path;
+    for (char& c : p) {
+        if (c == '\\') c = '/';
+    }
+
+    // Resolve "." and ".." segments; leading ".." just drops (keys are root-relative)
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= p.size()) {
+        size_t end = p.find('/', start);
+        if (end == std::string::npos) end = p.size();
+        std::string part = p.substr(start, end - start);
+        if (part == "..") {
+            if (!parts.empty()) parts.pop_back();
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = end + 1;
+    }
+
+    std::string out;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (i) out += '/';
+        out += parts[i];
+    }
+    return out;
+}
+
+uint64_t pack_hash(const std::string& normalizedPath) {
+    // FNV-1a 64
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : normalizedPath) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+namespace {
+
+// Arena::alloc asserts when it runs dry; an asset too big for the scratch
+// arena is a load failure instead (+8 covers the alignment padding)
+bool scratch_fits(const Arena& scratch, uint64_t bytes, const char* path) {
+    size_t available = scratch.size - scratch.offset;
+    if (bytes + 8 <= available) return true;
+    std::cout << "Asset does not fit in scratch: " << path << " (" << bytes << " bytes, "
+              << available << " available)" << std::endl;
+    return false;
+}
+
+} // namespace
+
+bool AssetPack::open(const char* path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    size = (size_t)fileSize.QuadPart;
+    base = (const unsigned char*)view;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PackHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    size = (size_t)st.st_size;
+    base = (const unsigned char*)view;
+#endif
+
+    header = (const PackHeader*)base;
+    if (size < sizeof(PackHeader) || memcmp(header->magic, PACK_MAGIC, 4) != 0 || header->version != PACK_VERSION ||
+        header->tocOffset > size || header->entryCount > (size - header->tocOffset) / sizeof(PackEntry) ||
+        header->tocOffset % alignof(PackEntry) != 0 || header->stringsOffset > size) {
+        std::cout << "Not a valid asset pack: " << path << std::endl;
+        close();
+        return false;
+    }
+    entries = (const PackEntry*)(base + header->tocOffset);
+
+    // Everything find() and read() index with is checked here once, so a
+    // truncated or corrupt pack is refused instead of read past the mapping
+    for (uint32_t i = 0; i < header->entryCount; ++i) {
+        const PackEntry& entry = entries[i];
+        uint64_t stringsSize = size - header->stringsOffset;
+        bool ok = entry.pathOffset < stringsSize &&
+                  memchr(base + header->stringsOffset + entry.pathOffset, 0, stringsSize - entry.pathOffset) != nullptr &&
+                  entry.offset <= size && entry.storedSize <= size - entry.offset &&
+                  (i == 0 || entries[i - 1].hash < entry.hash);
+        if (entry.compression == PACK_RAW) {
+            ok = ok && entry.rawSize == entry.storedSize;
+        } else if (entry.compression == PACK_LZ4) {
+            // LZ4 takes int sizes
+            ok = ok && entry.storedSize <= (uint64_t)LZ4_MAX_INPUT_SIZE && entry.rawSize <= (uint64_t)INT32_MAX;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cout << "Corrupt asset pack: " << path << " (entry " << i << ")" << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    std::cout << "Mapped Asset Pack " << path << " (" << header->entryCount << " entries, "
+              << size / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+void AssetPack::close() {
+    if (!base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle((HANDLE)mappingHandle);
+    CloseHandle((HANDLE)fileHandle);
+#else
+    munmap((void*)base, size);
+#endif
+    base = nullptr;
+    header = nullptr;
+    entries = nullptr;
+    size = 0;
+}
+
+const PackEntry* AssetPack::find(const char* path) const {
+    if (!base) return nullptr;
+
+    std::string key = pack_normalize_path(path);
+    uint64_t hash = pack_hash(key);
+
+    // Binary search the sorted TOC
+    uint32_t lo = 0, hi = header->entryCount;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (entries[mid].hash < hash) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == header->entryCount || entries[lo].hash != hash) return nullptr;
+
+    // The packer refuses collisions, but a stale pack could still disagree on the name
+    const char* name = (const char*)(base + header->stringsOffset + entries[lo].pathOffset);
+    return key == name ? &entries[lo] : nullptr;
+}
+
+bool AssetPack::read(const PackEntry& entry, Arena& scratch, AssetView& out) const {
+    if (entry.offset + entry.storedSize > size) return false;
+    const unsigned char* stored = base + entry.offset;
+
+    if (entry.compression == PACK_RAW) {
+        out.data = stored;
+        out.size = entry.storedSize;
+        return true;
+    }
+
+    if (entry.compression == PACK_LZ4) {
+        const char* path = (const char*)(base + header->stringsOffset + entry.pathOffset);
+        if (!scratch_fits(scratch, entry.rawSize, path)) return false;
+        unsigned char* raw = scratch.alloc_array<unsigned char>(entry.rawSize);
+        if (!raw) return false;
+        int n = LZ4_decompress_safe((const char*)stored, (char*)raw, (int)entry.storedSize, (int)entry.rawSize);
+        if (n != (int)entry.rawSize) return false;
+        out.data = raw;
+        out.size = entry.rawSize;
+        return true;
+    }
+    return false;
+}
+
+bool AssetSource::open_pack(const char* name) {
+    std::string nextToExe = exeDir + name;
+    return pack.open(nextToExe.c_str()) || pack.open(name);
+}
+
+bool AssetSource::load(const char* path, Arena& scratch, AssetView& out) const {
+    if (looseOverride || !pack.is_open()) {
+        // Same lookup as the pack: next to the executable first, then the working dir
+        bool relative = path[0] != '/' && path[0] != '\\' && !strchr(path, ':');
+        FILE* f = relative ? fopen((exeDir + path).c_str(), "rb") : nullptr;
+        if (!f) f = fopen(path, "rb");
+        if (f) {
+            fseek(f, 0, SEEK_END);
+            long fileSize = ftell(f);
+            fseek(f, 0, SEEK_SET);
+            if (fileSize < 0 || !scratch_fits(scratch, (uint64_t)fileSize + 1, path)) {
+                fclose(f);
+                return false;
+            }
+            // +1 so text assets (shaders, OBJ) can be '\0' terminated
+            unsigned char* data = scratch.alloc_array<unsigned char>(fileSize + 1);
+            bool ok = data && fread(data, 1, fileSize, f) == (size_t)fileSize;
+            fclose(f);
+            if (ok) {
+                data[fileSize] = 0;
+                out.data = data;
+                out.size = (size_t)fileSize;
+                return true;
+            }
+        }
+    }
+
+    const PackEntry* entry = pack.find(path);
+    return entry && pack.read(*entry, scratch, out);
+}
+
+std::string executable_dir() {
+    char buffer[4096] = {};
+#if defined(_WIN32)
+    DWORD n = GetModuleFileNameA(NULL, buffer, sizeof(buffer));
+    if (n == 0 || n == sizeof(buffer)) return "";
+#elif defined(__APPLE__)
+    uint32_t n = sizeof(buffer);
+    if (_NSGetExecutablePath(buffer, &n) != 0) return "";
+#else
+    ssize_t n = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+    if (n <= 0) return "";
+    buffer[n] = 0;
+#endif
+    std::string path = buffer;
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "arena.hpp"
+
+// Read-only bytes of one asset. Points into the mmap'd pack for raw entries,
+// or into a caller-provided arena for compressed entries and loose files.
+struct AssetView {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+};
+
+// --- Pack file layout (little-endian, offsets from the start of the file) ---
+//   PackHeader
+//   PackEntry[entryCount]   sorted by hash, binary searched
+//   path strings            '\0' terminated, for collision checks and listings
+//   entry data              each blob aligned to PACK_ALIGNMENT
+static constexpr char PACK_MAGIC[4] = { 'H', 'P', 'A', 'K' };
+static constexpr uint32_t PACK_VERSION = 1;
+static constexpr uint64_t PACK_ALIGNMENT = 16;
+
+enum PackCompression : uint32_t {
+    PACK_RAW = 0,
+    PACK_LZ4 = 1,
+};
+
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+    uint64_t tocOffset;
+    uint64_t stringsOffset;
+};
+
+struct PackEntry {
+    uint64_t hash;          // pack_hash(normalized path)
+    uint64_t offset;
+    uint64_t storedSize;    // Bytes in the pack
+    uint64_t rawSize;       // Bytes after decompression
+    uint32_t pathOffset;    // Into the string table
+    uint32_t compression;   // PackCompression
+};
+
+// "../assets/levels/01/x.png" -> "assets/levels/01/x.png": pack keys are root-relative
+std::string pack_normalize_path(const char* path);
+uint64_t pack_hash(const std::string& normalizedPath);
+
+// A memory-mapped .hpak
+struct AssetPack {
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+    const PackHeader* header = nullptr;
+    const PackEntry* entries = nullptr;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    bool open(const char* path);
+    void close();
+    bool is_open() const { return base != nullptr; }
+
+    const PackEntry* find(const char* path) const;
+
+    // Raw entries: zero-copy view into the mapping. LZ4 entries: decompressed into scratch.
+    bool read(const PackEntry& entry, Arena& scratch, AssetView& out) const;
+};
+
+// Directory of the running executable, with a trailing slash ("" if unknown)
+std::string executable_dir();
+
+// Where the runtime gets its bytes. Loose files win over packed ones when
+// looseOverride is on (development: edit a texture/shader, no repack needed).
+// Debug builds have it on; release builds only with -DHP3D_LOOSE_ASSETS=ON.
+struct AssetSource {
+    AssetPack pack;
+    std::string exeDir = executable_dir();  // Pack and loose paths are tried here first
+#ifdef HP3D_LOOSE_ASSETS
+    bool looseOverride = true;
+#else
+    bool looseOverride = false;
+#endif
+
+    // Tries <exe dir>/name, then ./name
+    bool open_pack(const char* name);
+    void close() { pack.close(); }
+
+    // The view stays valid until scratch is rolled back past it (or the pack closes)
+    bool load(const char* path, Arena& scratch, AssetView& out) const;
+};
+
@@ -0,0 +1,234 @@
+#include "crowd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "memory_tracker.hpp"
+
+bool Crowd::init(const MeshData& mesh, const std::vector<unsigned int>& textures,
+                 const char* animName, const AssetView& animFile, Arena& arena) {
+    characterCount = 1;
+    gpuSkinning = false;
+    scalarSkinning = false;
+    streamCapacity = 0;
+    palettes = nullptr;
+
+    // --- 1. Flatten the buckets into one bind-pose vertex list ---
+    vertexCount = 0;
+    for (const auto& bucket : mesh.buckets) vertexCount += (int)(bucket.vertices.size() / mesh.stride);
+    if (vertexCount == 0) return false;
+
+    glm::vec3 lo(1e30f), hi(-1e30f);
+    source = arena.alloc_array<SkinSource>(vertexCount);
+    float* uvs = arena.alloc_array<float>(vertexCount * 2);
+
+    int v = 0;
+    for (size_t b = 0; b < mesh.buckets.size(); ++b) {
+        const std::vector<float>& data = mesh.buckets[b].vertices;
+        int count = (int)(data.size() / mesh.stride);
+        parts.push_back({ textures[b], v, count, 0, 0 });
+
+        for (int i = 0; i < count; ++i, ++v) {
+            const float* src = &data[i * mesh.stride];
+            SkinSource& s = source[v];
+            s.position[0] = src[0]; s.position[1] = src[1]; s.position[2] = src[2]; s.position[3] = 1.0f;
+            s.normal[0] = src[5]; s.normal[1] = src[6]; s.normal[2] = src[7]; s.normal[3] = 0.0f;
+            uvs[v * 2 + 0] = src[3];
+            uvs[v * 2 + 1] = src[4];
+
+            glm::vec3 p(src[0], src[1], src[2]);
+            lo = glm::min(lo, p);
+            hi = glm::max(hi, p);
+        }
+    }
+
+    // --- 2. Rig: fit the skeleton to the mesh bounds, derive weights ---
+    if (!load_animation(animName, animFile, lo, hi, anim)) return false;
+    idleClip = anim.find_clip("idle");
+    walkClip = anim.find_clip("walk");
+    if (idleClip < 0 || walkClip < 0) {
+        std::cout << "Animation is missing the idle/walk clips: " << animName << std::endl;
+        return false;
+    }
+    auto_skin_weights(anim.skeleton, source, vertexCount);
+
+    // --- 3. GL buffers ---
+    glGenBuffers(1, &streamVBO);
+    glGenBuffers(1, &uvVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, uvVBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * 2 * sizeof(float), uvs, GL_STATIC_DRAW);
+    memory_tracker().track(MEM_GL_BUFFER, uvVBO, MEM_VERTEX, vertexCount * 2 * sizeof(float), "app");
+
+    // GPU path: bind pose pos/uv/normal (same layout as load_model) + joints + weights
+    const int gpuStride = 8 * sizeof(float) + 4 + 4 * sizeof(float);
+    unsigned char* gpuData = arena.alloc_array<unsigned char>((size_t)vertexCount * gpuStride);
+    for (int i = 0; i < vertexCount; ++i) {
+        float* f = (float*)(gpuData + (size_t)i * gpuStride);
+        f[0] = source[i].position[0]; f[1] = source[i].position[1]; f[2] = source[i].position[2];
+        f[3] = uvs[i * 2 + 0]; f[4] = uvs[i * 2 + 1];
+        f[5] = source[i].normal[0]; f[6] = source[i].normal[1]; f[7] = source[i].normal[2];
+        memcpy(gpuData + (size_t)i * gpuStride + 32, source[i].joints, 4);
+        memcpy(gpuData + (size_t)i * gpuStride + 36, source[i].weights, 16);
+    }
+    glGenBuffers(1, &gpuVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuVBO);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)vertexCount * gpuStride, gpuData, GL_STATIC_DRAW);
+    memory_tracker().track(MEM_GL_BUFFER, gpuVBO, MEM_VERTEX, (size_t)vertexCount * gpuStride, "app");
+
+    for (Part& part : parts) {
+        // CPU path: attribs 0/2 get re-pointed per character in draw()
+        glGenVertexArrays(1, &part.cpuVAO);
+        glBindVertexArray(part.cpuVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, uvVBO);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)(part.firstVertex * 2 * sizeof(float)));
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(2);
+
+        glGenVertexArrays(1, &part.gpuVAO);
+        glBindVertexArray(part.gpuVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, gpuVBO);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, gpuStride, (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, gpuStride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, gpuStride, (void*)(5 * sizeof(float)));
+        glEnableVertexAttribArray(4);
+        glVertexAttribIPointer(4, 4, GL_UNSIGNED_BYTE, gpuStride, (void*)32);
+        glEnableVertexAttribArray(5);
+        glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, gpuStride, (void*)36);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    std::cout << "Initialized Crowd (" << vertexCount << " verts, "
+              << anim.skeleton.joint_count() << " joints per character)" << std::endl;
+    return true;
+}
+
+void Crowd::destroy() {
+    for (Part& part : parts) {
+        glDeleteVertexArrays(1, &part.cpuVAO);
+        glDeleteVertexArrays(1, &part.gpuVAO);
+    }
+    parts.clear();
+    unsigned int buffers[] = { streamVBO, uvVBO, gpuVBO };
+    for (unsigned int buffer : buffers) memory_tracker().release(MEM_GL_BUFFER, buffer);
+    glDeleteBuffers(3, buffers);
+}
+
+glm::mat4 Crowd::character_transform(int i) const {
+    // Character 0 stands where the old static Harry did, the rest fill rows behind it
+    const int columns = 16;
+    const float spacing = 4.0f;
+    glm::vec3 position(0.0f);
+    if (i > 0) {
+        int row = (i - 1) / columns;
+        int col = (i - 1) % columns;
+        position = glm::vec3((col - (columns - 1) * 0.5f) * spacing, 0.0f, -(row + 1) * spacing);
+    }
+
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    return glm::scale(model, glm::vec3(0.1f)); // Scale down 10x
+}
+
+void Crowd::simulate(float t, JobSystem& jobs, Arena& scratch, float* out) {
+    const Skeleton& skel = anim.skeleton;
+    int jointCount = skel.joint_count();
+
+    // All scratch comes from the arena up front: workers never allocate
+    palettes = scratch.alloc_array<float>((size_t)characterCount * jointCount * 16);
+    glm::quat* rotations = scratch.alloc_array<glm::quat>((size_t)characterCount * jointCount * 2);
+
+    const AnimClip& idle = anim.clips[idleClip];
+    const AnimClip& walk = anim.clips[walkClip];
+    auto skin = scalarSkinning ? skin_vertices_scalar : skin_vertices;
+
+    jobs.parallel_for(characterCount, 4, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            Pose a = { rotations + (size_t)i * jointCount * 2, glm::vec3(0.0f) };
+            Pose b = { a.rotations + jointCount, glm::vec3(0.0f) };
+
+            // Each character gets its own phase and drifts between idle and walk
+            float phase = i * 0.618f;
+            float walkWeight = 0.5f + 0.5f * sinf(t * 0.4f + i * 1.3f);
+            sample_clip(anim, idle, t + phase * idle.duration, a);
+            sample_clip(anim, walk, t + phase * walk.duration, b);
+            blend_poses(jointCount, a, b, walkWeight, a);
+
+            float* palette = palettes + (size_t)i * jointCount * 16;
+            compute_skin_matrices(skel, a, palette);
+
+            if (out) skin(source, vertexCount, palette, out + (size_t)i * vertexCount * SKINNED_FLOATS);
+        }
+    });
+}
+
+bool Crowd::update(float t, JobSystem& jobs, Arena& frameArena) {
+    if (parts.empty()) return false;
+
+    if (gpuSkinning) {
+        simulate(t, jobs, frameArena, nullptr);
+        return true;
+    }
+
+    // Grow the stream buffer when the crowd grows
+    size_t bytes = (size_t)characterCount * vertexCount * SKINNED_FLOATS * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, streamVBO);
+    if (characterCount > streamCapacity) {
+        glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+        memory_tracker().track(MEM_GL_BUFFER, streamVBO, MEM_STREAM, bytes, "app");
+        streamCapacity = characterCount;
+    }
+
+    // Invalidate: the driver hands us fresh memory instead of waiting on last frame's draws
+    float* mapped = (float*)glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes,
+                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return false;
+    }
+
+    simulate(t, jobs, frameArena, mapped);
+
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void Crowd::draw(unsigned int program) const {
+    int modelLoc = glGetUniformLocation(program, "model");
+    int jointsLoc = glGetUniformLocation(program, "u_Joints");
+    int jointCount = anim.skeleton.joint_count();
+
+    for (int i = 0; i < characterCount; ++i) {
+        glm::mat4 model = character_transform(i);
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+        if (gpuSkinning) {
+            glUniformMatrix4fv(jointsLoc, jointCount, GL_FALSE, palettes + (size_t)i * jointCount * 16);
+        }
+
+        for (const Part& part : parts) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, part.textureID);
+
+            if (gpuSkinning) {
+                glBindVertexArray(part.gpuVAO);
+                glDrawArrays(GL_TRIANGLES, part.firstVertex, part.vertexCount);
+            } else {
+                // Point pos/normal at this character's slice of the stream
+                size_t base = ((size_t)i * vertexCount + part.firstVertex) * SKINNED_FLOATS * sizeof(float);
+                glBindVertexArray(part.cpuVAO);
+                glBindBuffer(GL_ARRAY_BUFFER, streamVBO);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, SKINNED_FLOATS * sizeof(float), (void*)base);
+                glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, SKINNED_FLOATS * sizeof(float), (void*)(base + 4 * sizeof(float)));
+                glDrawArrays(GL_TRIANGLES, 0, part.vertexCount);
+            }
+        }
+    }
+    glBindVertexArray(0);
+}
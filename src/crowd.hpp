@@ -0,0 +1,64 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "animation.hpp"
+#include "arena.hpp"
+#include "job_system.hpp"
+#include "mesh_data.hpp"
+#include "skinning.hpp"
+
+// A crowd of skinned characters sharing one mesh + rig (students, enemies...).
+//
+// Per frame, on the job system: sample idle + walk, blend, build the joint palette,
+// then (CPU path) skin straight into a mapped streaming VBO. The GPU path skips the
+// skinning and hands the palette to retro.vert's SKINNING variant instead.
+struct Crowd {
+    static constexpr int MAX_CHARACTERS = 256;
+
+    struct Part {               // One per material bucket
+        unsigned int textureID;
+        int firstVertex;        // Offset inside one character's vertex range
+        int vertexCount;
+        unsigned int cpuVAO;    // Streamed pos/normal + static uv
+        unsigned int gpuVAO;    // Static bind pose + joints/weights
+    };
+
+    AnimSet anim;
+    std::vector<Part> parts;
+    int idleClip;
+    int walkClip;
+
+    SkinSource* source;         // Bind pose, from the level arena
+    int vertexCount;            // Per character
+
+    unsigned int streamVBO;     // CPU skinned output, characterCount * vertexCount
+    unsigned int uvVBO;
+    unsigned int gpuVBO;
+    int streamCapacity;         // Characters the stream buffer currently holds
+
+    int characterCount;
+    bool gpuSkinning;
+    bool scalarSkinning;        // Benchmark/debug: bypass the SSE path
+
+    float* palettes;            // This frame's joint palettes (frame arena)
+
+    // textures[i] goes with mesh.buckets[i], animFile is the .hpanim rig
+    bool init(const MeshData& mesh, const std::vector<unsigned int>& textures,
+              const char* animName, const AssetView& animFile, Arena& arena);
+    void destroy();
+
+    // Poses (and CPU skinning) for time t. Returns false if there is nothing to draw.
+    bool update(float t, JobSystem& jobs, Arena& frameArena);
+
+    // Pose + skin without touching GL (out = characterCount * vertexCount * SKINNED_FLOATS,
+    // or nullptr for palettes only). update() and the benchmark both go through this.
+    void simulate(float t, JobSystem& jobs, Arena& scratch, float* out);
+
+    // program: retro (CPU path) or retro+SKINNING (GPU path)
+    void draw(unsigned int program) const;
+
+    glm::mat4 character_transform(int i) const;
+};
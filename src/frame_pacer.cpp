@@ -0,0 +1,79 @@
+#include "frame_pacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+void FramePacer::set_cap(int fps) {
+    targetSeconds = fps > 0 ? 1.0 / fps : 0.0;
+    nextDeadline = Clock::now();
+}
+
+void FramePacer::wait() {
+    if (targetSeconds <= 0.0) return;
+
+    nextDeadline += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetSeconds));
+
+    // Fell behind (hitch, breakpoint...): re-anchor instead of racing to catch up
+    Clock::time_point now = Clock::now();
+    if (nextDeadline < now) {
+        nextDeadline = now;
+        return;
+    }
+
+    // Sleep in 1ms slices until we're within the expected overshoot,
+    // learning the overshoot from each slice
+    for (;;) {
+        double remaining = std::chrono::duration<double>(nextDeadline - Clock::now()).count();
+        if (remaining <= oversleepEstimate) break;
+
+        double slice = std::min(remaining - oversleepEstimate, 1e-3);
+        Clock::time_point before = Clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(slice));
+        double overshoot = std::chrono::duration<double>(Clock::now() - before).count() - slice;
+
+        // Fast attack, slow decay: one bad oversleep costs a frame, an early wake costs a few yields
+        if (overshoot > oversleepEstimate) oversleepEstimate = overshoot;
+        else oversleepEstimate = oversleepEstimate * 0.99 + std::max(overshoot, 0.0) * 0.01;
+    }
+
+    // Last sliver: give the core away instead of burning it
+    while (Clock::now() < nextDeadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FrameStats::add(double frameSeconds, Arena& scratch) {
+    samples[count % WINDOW] = (float)(frameSeconds * 1000.0);
+    count++;
+    sinceLog += frameSeconds;
+    if (sinceLog < LOG_INTERVAL) return;
+    sinceLog = 0.0;
+
+    int n = std::min(count, WINDOW);
+    double sum = 0.0, sumSq = 0.0;
+    float* sorted = scratch.alloc_array<float>(n);
+    for (int i = 0; i < n; ++i) {
+        sum += samples[i];
+        sumSq += (double)samples[i] * samples[i];
+        sorted[i] = samples[i];
+    }
+    std::sort(sorted, sorted + n);
+
+    meanMs = sum / n;
+    stddevMs = std::sqrt(std::max(sumSq / n - meanMs * meanMs, 0.0));
+    minMs = sorted[0];
+    maxMs = sorted[n - 1];
+    p99Ms = sorted[std::min(n - 1, (int)(n * 0.99))];
+
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1) << "[frame] " << std::setw(6) << 1000.0 / meanMs << " fps"
+         << std::setprecision(2) << "  mean " << std::setw(6) << meanMs << " ms  sd " << std::setw(5) << stddevMs
+         << "  min " << std::setw(6) << minMs << "  max " << std::setw(6) << maxMs << "  p99 " << std::setw(6) << p99Ms
+         << "  (" << n << " frames)";
+    std::cout << line.str() << std::endl;
+    count = 0;
+}
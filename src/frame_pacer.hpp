@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+
+#include "arena.hpp"
+
+// Caps the frame rate by sleeping, not spinning.
+// OS sleeps overshoot by a platform-dependent amount (tens of us on Linux, up to a
+// timer tick on Windows), so we track how much they overshoot and wake up that
+// much early, then yield for the last sliver.
+struct FramePacer {
+    using Clock = std::chrono::steady_clock;
+
+    double targetSeconds = 0.0;     // 0 = uncapped
+    double oversleepEstimate = 0.5e-3;
+    Clock::time_point nextDeadline;
+
+    void set_cap(int fps);
+
+    // Call once per frame after the swap. Returns immediately when uncapped.
+    void wait();
+};
+
+// Rolling frame-time window, logged every few seconds so pacing can be checked
+struct FrameStats {
+    static constexpr int WINDOW = 1024;
+    static constexpr double LOG_INTERVAL = 5.0;
+
+    float samples[WINDOW];  // Milliseconds
+    int count = 0;
+    double sinceLog = 0.0;
+
+    // Last logged values (also what the overlay shows)
+    double meanMs = 0.0;
+    double stddevMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double p99Ms = 0.0;
+
+    // scratch is only used when a log line is due (sorting for p99)
+    void add(double frameSeconds, Arena& scratch);
+};
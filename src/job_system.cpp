@@ -0,0 +1,76 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+
+void JobSystem::init(int workerCount) {
+    if (workerCount <= 0) {
+        workerCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+    m_Quit = false;
+    for (int i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+void JobSystem::destroy() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+    }
+    m_Wake.notify_all();
+    for (auto& worker : m_Workers) worker.join();
+    m_Workers.clear();
+}
+
+void JobSystem::run_chunks() {
+    for (;;) {
+        int begin = m_Next.fetch_add(m_Grain);
+        if (begin >= m_Count) return;
+        (*m_Job)(begin, std::min(begin + m_Grain, m_Count));
+    }
+}
+
+void JobSystem::worker_loop() {
+    unsigned int seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [&]() { return m_Quit || m_Generation != seen; });
+            if (m_Quit) return;
+            seen = m_Generation;
+        }
+
+        run_chunks();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (--m_Busy == 0) m_Done.notify_one();
+    }
+}
+
+void JobSystem::parallel_for(int count, int grain, const RangeFn& fn) {
+    if (count <= 0) return;
+    grain = std::max(grain, 1);
+
+    // Not worth waking anyone for a single chunk
+    if (m_Workers.empty() || count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Job = &fn;
+        m_Count = count;
+        m_Grain = grain;
+        m_Next = 0;
+        m_Busy = (int)m_Workers.size();
+        m_Generation++;
+    }
+    m_Wake.notify_all();
+
+    run_chunks();
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Done.wait(lock, [&]() { return m_Busy == 0; });
+    m_Job = nullptr;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads for data-parallel frame work (pose sampling, skinning).
+// One job at a time: parallel_for() hands out [begin, end) chunks from an atomic
+// counter and the calling thread pitches in until every chunk is done.
+struct JobSystem {
+    using RangeFn = std::function<void(int begin, int end)>;
+
+    // workerCount = 0 picks hardware_concurrency - 1 (the caller is the extra thread)
+    void init(int workerCount = 0);
+    void destroy();
+
+    void parallel_for(int count, int grain, const RangeFn& fn);
+
+    int thread_count() const { return (int)m_Workers.size() + 1; }
+
+private:
+    void worker_loop();
+    void run_chunks();
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    std::condition_variable m_Done;
+
+    const RangeFn* m_Job = nullptr;
+    int m_Count = 0;
+    int m_Grain = 1;
+    std::atomic<int> m_Next{0};
+    int m_Busy = 0;              // Workers still inside the current job
+    unsigned int m_Generation = 0;
+    bool m_Quit = false;
+};
@@ -0,0 +1,316 @@
+#include "level.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <glad/glad.h>
+
+#include "memory_tracker.hpp"
+#include "mesh_data.hpp"
+#include "stb_image.h"
+
+namespace {
+
+// Keyed by a copy of the owner: Level::owner is rewritten on every begin_load
+std::vector<std::pair<std::string, GLObjectCounts>>& owner_counts() {
+    static std::vector<std::pair<std::string, GLObjectCounts>> counts;
+    return counts;
+}
+
+} // namespace
+
+GLObjectCounts& gl_object_counts(const char* owner) {
+    auto& counts = owner_counts();
+    for (auto& entry : counts) {
+        if (entry.first == owner) return entry.second;
+    }
+    counts.push_back({ owner, GLObjectCounts() });
+    return counts.back().second;
+}
+
+void drop_gl_object_counts(const char* owner) {
+    auto& counts = owner_counts();
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i].first == owner && counts[i].second.total() == 0) {
+            counts.erase(counts.begin() + i);
+            return;
+        }
+    }
+}
+
+SubMesh upload_submesh(const float* vertices, size_t floatCount, int stride, unsigned int textureID, const char* owner) {
+    SubMesh subMesh = {};
+    subMesh.textureID = textureID;
+    subMesh.vertexCount = (int)(floatCount / stride);
+    subMesh.baked = stride == MeshData::MESH_BAKED_STRIDE;
+
+    glGenVertexArrays(1, &subMesh.vao);
+    glGenBuffers(1, &subMesh.vbo);
+    glBindVertexArray(subMesh.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, subMesh.vbo);
+    glBufferData(GL_ARRAY_BUFFER, floatCount * sizeof(float), vertices, GL_STATIC_DRAW);
+    memory_tracker().track(MEM_GL_BUFFER, subMesh.vbo, MEM_VERTEX, floatCount * sizeof(float), owner);
+    GLObjectCounts& live = gl_object_counts(owner);
+    live.vaos++;
+    live.buffers++;
+
+    int strideBytes = stride * sizeof(float);
+
+    // 1. Position (Location 0)
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, strideBytes, (void*)0);
+
+    // 2. Tex (Location 1) - Offset 3 floats
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, strideBytes, (void*)(3 * sizeof(float)));
+
+    // 3. Normals (Location 2) - Offset 5 floats
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, strideBytes, (void*)(5 * sizeof(float)));
+
+    // 4. Baked Color (Location 3) - Offset 8 floats, baked meshes only
+    if (subMesh.baked) {
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, strideBytes, (void*)(8 * sizeof(float)));
+    }
+
+    glBindVertexArray(0);
+    return subMesh;
+}
+
+unsigned int upload_texture(const unsigned char* pixels, int width, int height, int channels, const char* owner) {
+    GLenum format = GL_RGBA;
+    if (channels == 1) format = GL_RED;
+    else if (channels == 3) format = GL_RGB;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    memory_tracker().track(MEM_GL_TEXTURE, textureID, MEM_TEXTURE, texture_bytes(width, height, channels, true), owner);
+    gl_object_counts(owner).textures++;
+
+    // PS1 Style: Pixelated textures (Nearest Neighbor)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return textureID;
+}
+
+void GLObjectList::release(const char* owner) {
+    // VAOs first so the buffers aren't still referenced when they go
+    if (!vaos.empty()) glDeleteVertexArrays((GLsizei)vaos.size(), vaos.data());
+    if (!buffers.empty()) glDeleteBuffers((GLsizei)buffers.size(), buffers.data());
+    if (!textures.empty()) glDeleteTextures((GLsizei)textures.size(), textures.data());
+
+    MemoryTracker& tracker = memory_tracker();
+    for (unsigned int name : buffers) tracker.release(MEM_GL_BUFFER, name);
+    for (unsigned int name : textures) tracker.release(MEM_GL_TEXTURE, name);
+
+    GLObjectCounts& live = gl_object_counts(owner);
+    live.vaos -= (int)vaos.size();
+    live.buffers -= (int)buffers.size();
+    live.textures -= (int)textures.size();
+
+    vaos.clear();
+    buffers.clear();
+    textures.clear();
+}
+
+void Level::begin_load(const LevelDesc& levelDesc, int slot, Arena& levelArena, const AssetSource& assets) {
+    desc = &levelDesc;
+    snprintf(owner, sizeof(owner), "%s:%d", desc->name, slot);
+    arena = &levelArena;
+    arena->reset();
+    arena->reset_peak();
+    state = LOADING;
+    loader = std::thread([this, &assets]() { load(assets); });
+}
+
+void Level::wait() {
+    if (loader.joinable()) loader.join();
+}
+
+void Level::load(const AssetSource& assets) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    // --- 1. Lights (kept, so they go first and sit below keepOffset) ---
+    lights = arena->alloc_array<PointLight>(MAX_LIGHTS);
+    lightCount = 0;
+    size_t mark = arena->offset;
+    AssetView file;
+    if (assets.load(desc->lightsPath, *arena, file)) lightCount = parse_light_file(file, lights, MAX_LIGHTS);
+    arena->offset = mark;
+    keepOffset = arena->offset;
+
+    // --- 2. Mesh: first path that parses wins ---
+    MeshData mesh;
+    const char* meshPath = nullptr;
+    MeshFileLoader loadFile = [this, &assets](const std::string& path, AssetView& out) {
+        return assets.load(path.c_str(), *arena, out);
+    };
+    for (const char* path : desc->meshPaths) {
+        if (!path) continue;
+        std::string pathStr = path;
+        bool isBaked = pathStr.size() > 7 && pathStr.compare(pathStr.size() - 7, 7, ".hpmesh") == 0;
+        mark = arena->offset;
+        bool parsed = assets.load(path, *arena, file) &&
+                      (isBaked ? load_baked_mesh(path, file, mesh) : load_obj_mesh(path, file, loadFile, mesh));
+        arena->offset = mark;
+        if (parsed) {
+            meshPath = path;
+            break;
+        }
+        mesh = MeshData();
+    }
+
+    // --- 3. Vertices and textures into the arena (duplicate texture paths decode once) ---
+    if (meshPath) {
+        std::string baseDir = mesh_base_dir(meshPath);
+        stride = mesh.stride;
+        stbi_set_flip_vertically_on_load_thread(true);
+        for (auto& bucket : mesh.buckets) {
+            Part part;
+            part.floatCount = bucket.vertices.size();
+            part.vertices = arena->alloc_array<float>(part.floatCount);
+            memcpy(part.vertices, bucket.vertices.data(), part.floatCount * sizeof(float));
+            std::vector<float>().swap(bucket.vertices);
+            part.image = -1;
+
+            if (!bucket.texture.empty()) {
+                std::string texPath = baseDir + bucket.texture;
+                for (size_t i = 0; i < images.size() && part.image < 0; ++i) {
+                    if (images[i].path == texPath) part.image = (int)i;
+                }
+                if (part.image < 0) {
+                    Image image = { texPath, nullptr, 0, 0, 0 };
+                    mark = arena->offset;
+                    unsigned char* decoded = nullptr;
+                    if (assets.load(texPath.c_str(), *arena, file)) {
+                        decoded = stbi_load_from_memory(file.data, (int)file.size,
+                                                        &image.width, &image.height, &image.channels, 0);
+                    }
+                    arena->offset = mark;
+                    if (decoded) {
+                        size_t bytes = (size_t)image.width * image.height * image.channels;
+                        image.pixels = arena->alloc_array<unsigned char>(bytes);
+                        memcpy(image.pixels, decoded, bytes);
+                        stbi_image_free(decoded);
+                        part.image = (int)images.size();
+                        images.push_back(image);
+                    } else {
+                        std::cout << "Texture failed to load at path: " << texPath << std::endl;
+                    }
+                }
+            }
+            parts.push_back(part);
+        }
+    }
+
+    // --- 4. Sky ---
+    mark = arena->offset;
+    AssetView skyFiles[6];
+    bool haveSky = true;
+    for (int i = 0; i < 6; ++i) haveSky = haveSky && assets.load(desc->skyFaces[i], *arena, skyFiles[i]);
+    SkyFaces faces;
+    if (haveSky && decode_sky_faces(skyFiles, *arena, faces)) {
+        // The decoded faces landed after the files; slide them down over the file bytes
+        size_t faceBytes = (size_t)faces.width * faces.height * 3;
+        arena->offset = mark;
+        for (int i = 0; i < 6; ++i) {
+            unsigned char* dst = arena->alloc_array<unsigned char>(faceBytes);
+            memmove(dst, faces.pixels[i], faceBytes);
+            faces.pixels[i] = dst;
+        }
+        sky = faces;
+    } else {
+        if (!haveSky) std::cout << "Skybox failed to load for level " << desc->name << std::endl;
+        arena->offset = mark;
+    }
+
+    loadMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    // A level missing its mesh still has its sky and lights
+    loadOk = meshPath != nullptr || sky.valid();
+    state = LOADED;
+}
+
+bool Level::activate(unsigned int fallbackTexture) {
+    wait();
+    if (!loadOk) {
+        std::cout << "Level " << desc->name << " failed to load" << std::endl;
+        return false;
+    }
+
+    std::vector<unsigned int> imageTextures(images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        const Image& image = images[i];
+        imageTextures[i] = upload_texture(image.pixels, image.width, image.height, image.channels, owner);
+        gl.textures.push_back(imageTextures[i]);
+    }
+
+    for (const Part& part : parts) {
+        unsigned int texture = part.image >= 0 ? imageTextures[part.image] : fallbackTexture;
+        SubMesh subMesh = upload_submesh(part.vertices, part.floatCount, stride, texture, owner);
+        gl.vaos.push_back(subMesh.vao);
+        gl.buffers.push_back(subMesh.vbo);
+        model.push_back(subMesh);
+    }
+
+    if (sky.valid()) {
+        cubemap = upload_cubemap(sky, owner);
+        gl.textures.push_back(cubemap);
+    }
+
+    // Everything past the lights was only there to reach the GPU
+    parts.clear();
+    images.clear();
+    sky = SkyFaces();
+    arena->offset = keepOffset;
+
+    std::cout << "Loaded Level " << desc->name << ": " << model.size() << " sub-meshes"
+              << (stride == MeshData::MESH_BAKED_STRIDE ? " (baked)" : "") << ", "
+              << imageTextures.size() << " textures, " << lightCount << " static lights" << std::endl;
+    state = ACTIVE;
+    return true;
+}
+
+bool Level::unload() {
+    wait();
+    if (state.load() == EMPTY) return true;
+
+    int objects = gl.count();
+    gl.release(owner);
+
+    // Anything the upload helpers made for this level that the list didn't hold
+    // is still counted, and still has bytes filed under the owner
+    GLObjectCounts live = gl_object_counts(owner);
+    size_t liveBytes = 0;
+    for (int c = 0; c < MEM_CATEGORY_COUNT; ++c) liveBytes += memory_tracker().owner_bytes(owner, (MemCategory)c);
+    std::cout << "[level] unloaded " << owner << ": released " << objects << " GL objects";
+    if (live.total() != 0 || liveBytes != 0) {
+        std::cout << ", LEAKED " << live.vaos << " VAOs, " << live.buffers << " buffers, "
+                  << live.textures << " textures (" << liveBytes << " bytes)";
+    }
+    std::cout << std::endl;
+    bool clean = live.total() == 0 && liveBytes == 0;
+    drop_gl_object_counts(owner);
+
+    model.clear();
+    parts.clear();
+    images.clear();
+    sky = SkyFaces();
+    cubemap = 0;
+    lights = nullptr;
+    lightCount = 0;
+    stride = 0;
+    loadOk = false;
+    if (arena) arena->reset();
+    state = EMPTY;
+    return clean;
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arena.hpp"
+#include "asset_pack.hpp"
+#include "lights.hpp"
+#include "skybox.hpp"
+
+// GPU half of a MeshData bucket
+struct SubMesh {
+    unsigned int vao;
+    unsigned int vbo;
+    unsigned int textureID;
+    int vertexCount;
+    bool baked;     // Has a baked color attribute (location 3)
+};
+
+// Live GL objects made by upload_submesh / upload_texture / upload_cubemap, per owner.
+// The upload helpers count up and GLObjectList::release counts down, so an owner
+// that isn't back to zero after unloading leaked something.
+struct GLObjectCounts {
+    int vaos = 0;
+    int buffers = 0;
+    int textures = 0;
+
+    int total() const { return vaos + buffers + textures; }
+};
+
+// Main thread only
+GLObjectCounts& gl_object_counts(const char* owner);
+// Forgets the owner once its counts are back at zero (a leak stays on record)
+void drop_gl_object_counts(const char* owner);
+
+// Main thread only. stride is in floats (MeshData::MESH_STRIDE or MESH_BAKED_STRIDE).
+// owner ("app" or a Level's owner name) is what the memory tracker and the object
+// counts file the upload under.
+SubMesh upload_submesh(const float* vertices, size_t floatCount, int stride, unsigned int textureID, const char* owner);
+unsigned int upload_texture(const unsigned char* pixels, int width, int height, int channels, const char* owner);
+
+// Everything a level reads, by path
+struct LevelDesc {
+    const char* name;
+    const char* meshPaths[2];   // Tried in order: baked .hpmesh, then the raw OBJ
+    const char* lightsPath;
+    const char* skyFaces[6];    // GL cubemap order: +X, -X, +Y, -Y, +Z, -Z
+};
+
+// Every GL name a level created, so unload can free them in bulk
+struct GLObjectList {
+    std::vector<unsigned int> vaos;
+    std::vector<unsigned int> buffers;
+    std::vector<unsigned int> textures;
+
+    int count() const { return (int)(vaos.size() + buffers.size() + textures.size()); }
+
+    // Deletes everything, drops it from the memory tracker and owner's counts
+    void release(const char* owner);
+};
+
+// One level's lifetime:
+//   begin_load()  worker thread: read, parse and decode into the level's arena (no GL)
+//   activate()    main thread: upload to GL, roll the arena back to what rendering keeps
+//   unload()      main thread: delete every GL object the level made, reset its arena
+//
+// App keeps two of these on two arenas, so the next level streams in while the
+// current one still renders.
+struct Level {
+    enum State { EMPTY, LOADING, LOADED, ACTIVE };
+
+    static constexpr int MAX_LIGHTS = 255;
+
+    const LevelDesc* desc = nullptr;
+    Arena* arena = nullptr;
+    char owner[32] = {};        // "<level name>:<slot>", so a reload into the other slot is accounted apart
+    std::atomic<int> state{ EMPTY };
+    std::atomic<bool> loadOk{ false };
+    std::thread loader;
+    double loadMs = 0.0;        // Worker time, written before state becomes LOADED
+
+    // --- CPU side (arena) ---
+    struct Image {
+        std::string path;
+        unsigned char* pixels;
+        int width, height, channels;
+    };
+    struct Part {
+        float* vertices;
+        size_t floatCount;
+        int image;              // Into images, -1 = untextured
+    };
+    int stride = 0;
+    std::vector<Part> parts;
+    std::vector<Image> images;
+    SkyFaces sky;
+    PointLight* lights = nullptr;   // Static torches, kept for the level's lifetime
+    int lightCount = 0;
+    size_t keepOffset = 0;          // Arena offset after the lights: everything above is load staging
+
+    // --- GPU side ---
+    std::vector<SubMesh> model;
+    unsigned int cubemap = 0;
+    GLObjectList gl;
+
+    void begin_load(const LevelDesc& levelDesc, int slot, Arena& levelArena, const AssetSource& assets);
+    bool ready() const { return state.load() == LOADED; }
+    void wait();
+
+    bool activate(unsigned int fallbackTexture);
+    // False if GL objects or tracked bytes outlived the level (logged as LEAKED)
+    bool unload();
+
+private:
+    void load(const AssetSource& assets);
+};
@@ -0,0 +1,220 @@
+#include "lights.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "memory_tracker.hpp"
+
+namespace {
+
+struct TileRect {
+    int x0, y0, x1, y1; // Inclusive tile range, x0 > x1 means culled
+};
+
+void create_texture_buffer(unsigned int& buffer, unsigned int& texture, GLenum format) {
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+}
+
+void upload(unsigned int buffer, const void* data, size_t bytes) {
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    // Orphan then fill, so we never wait on last frame's draw still reading it
+    glBufferData(GL_TEXTURE_BUFFER, std::max<size_t>(bytes, 16), nullptr, GL_STREAM_DRAW);
+    if (bytes > 0) glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    memory_tracker().track(MEM_GL_BUFFER, buffer, MEM_STREAM, std::max<size_t>(bytes, 16), "app");
+}
+
+// Conservative screen-space bounds of a light sphere, in tiles
+TileRect light_tiles(const PointLight& light, const glm::mat4& view, const glm::mat4& projection,
+                     float nearPlane, const LightGrid& grid) {
+    TileRect full = { 0, 0, grid.tilesX - 1, grid.tilesY - 1 };
+    TileRect culled = { 1, 0, 0, 0 };
+
+    // View space looks down -Z
+    glm::vec3 c = glm::vec3(view * glm::vec4(light.position, 1.0f));
+    float r = light.range;
+
+    if (c.z - r > -nearPlane) return culled;  // Entirely behind the camera
+    if (c.z + r > -nearPlane) return full;    // Straddles the near plane, don't bother
+
+    // Project the 8 corners of the view-space AABB and take their 2D bounds
+    glm::vec2 lo(1e9f), hi(-1e9f);
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner(c.x + ((i & 1) ? r : -r),
+                         c.y + ((i & 2) ? r : -r),
+                         c.z + ((i & 4) ? r : -r));
+        glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+        glm::vec2 ndc(clip.x / clip.w, clip.y / clip.w);
+        lo.x = std::min(lo.x, ndc.x); lo.y = std::min(lo.y, ndc.y);
+        hi.x = std::max(hi.x, ndc.x); hi.y = std::max(hi.y, ndc.y);
+    }
+
+    if (hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f) return culled;
+
+    // NDC -> pixels (bottom-left origin, same as gl_FragCoord) -> tiles
+    auto to_tile_x = [&](float ndc) { return (int)((ndc * 0.5f + 0.5f) * grid.width) / LightGrid::TILE_SIZE; };
+    auto to_tile_y = [&](float ndc) { return (int)((ndc * 0.5f + 0.5f) * grid.height) / LightGrid::TILE_SIZE; };
+
+    TileRect rect;
+    rect.x0 = std::clamp(to_tile_x(lo.x), 0, grid.tilesX - 1);
+    rect.x1 = std::clamp(to_tile_x(hi.x), 0, grid.tilesX - 1);
+    rect.y0 = std::clamp(to_tile_y(lo.y), 0, grid.tilesY - 1);
+    rect.y1 = std::clamp(to_tile_y(hi.y), 0, grid.tilesY - 1);
+    return rect;
+}
+
+} // namespace
+
+void LightGrid::init(int target_width, int target_height) {
+    resize(target_width, target_height);
+    lightCount = 0;
+    indexCount = 0;
+
+    create_texture_buffer(lightBuffer, lightTexture, GL_RGBA32F);
+    create_texture_buffer(tileBuffer, tileTexture, GL_RGBA32UI);
+    create_texture_buffer(indexBuffer, indexTexture, GL_R32UI);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightGrid::resize(int target_width, int target_height) {
+    width = target_width;
+    height = target_height;
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+}
+
+void LightGrid::destroy() {
+    unsigned int textures[] = { lightTexture, tileTexture, indexTexture };
+    unsigned int buffers[] = { lightBuffer, tileBuffer, indexBuffer };
+    for (unsigned int buffer : buffers) memory_tracker().release(MEM_GL_BUFFER, buffer);
+    glDeleteTextures(3, textures);
+    glDeleteBuffers(3, buffers);
+}
+
+void LightGrid::build(const PointLight* lights, int count,
+                      const glm::mat4& view, const glm::mat4& projection, float nearPlane,
+                      Arena& scratch) {
+    count = std::min(count, MAX_LIGHTS);
+    int tileCount = tilesX * tilesY;
+
+    // --- 1. Bounds + per-tile counts ---
+    TileRect* rects = scratch.alloc_array<TileRect>(count);
+    unsigned int* tiles = scratch.alloc_array<unsigned int>(tileCount * 4); // (offset, count, dynamic count, -)
+    memset(tiles, 0, tileCount * 4 * sizeof(unsigned int));
+
+    for (int i = 0; i < count; ++i) {
+        rects[i] = light_tiles(lights[i], view, projection, nearPlane, *this);
+        for (int y = rects[i].y0; y <= rects[i].y1; ++y)
+            for (int x = rects[i].x0; x <= rects[i].x1; ++x)
+                tiles[(y * tilesX + x) * 4 + 1]++;
+    }
+
+    // --- 2. Prefix sum -> offsets, clamping to the index budget ---
+    unsigned int* capacity = scratch.alloc_array<unsigned int>(tileCount);
+    unsigned int total = 0;
+    for (int t = 0; t < tileCount; ++t) {
+        capacity[t] = std::min<unsigned int>(tiles[t * 4 + 1], MAX_INDICES - total);
+        tiles[t * 4 + 0] = total;
+        tiles[t * 4 + 1] = 0; // Reused as the fill cursor below
+        total += capacity[t];
+    }
+
+    // --- 3. Scatter light indices ---
+    // Dynamic lights first, then static: the BAKED_LIGHTING variant only reads the
+    // dynamic prefix (static ones are in its vertex colors), the full list is for
+    // everything else. Over budget, static lights are the ones dropped.
+    unsigned int* indices = scratch.alloc_array<unsigned int>(std::max(total, 1u));
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < count; ++i) {
+            bool isStatic = lights[i].isStatic > 0.5f;
+            if (isStatic != (pass == 1)) continue;
+            for (int y = rects[i].y0; y <= rects[i].y1; ++y) {
+                for (int x = rects[i].x0; x <= rects[i].x1; ++x) {
+                    int t = y * tilesX + x;
+                    if (tiles[t * 4 + 1] == capacity[t]) continue; // Budget hit, drop the light here
+                    indices[tiles[t * 4 + 0] + tiles[t * 4 + 1]++] = (unsigned int)i;
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int t = 0; t < tileCount; ++t) tiles[t * 4 + 2] = tiles[t * 4 + 1];
+        }
+    }
+
+    // --- 4. Upload ---
+    upload(lightBuffer, lights, count * sizeof(PointLight));
+    upload(tileBuffer, tiles, tileCount * 4 * sizeof(unsigned int));
+    upload(indexBuffer, indices, total * sizeof(unsigned int));
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    lightCount = count;
+    indexCount = (int)total;
+}
+
+void LightGrid::bind(unsigned int shader, int firstUnit) const {
+    glActiveTexture(GL_TEXTURE0 + firstUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+    glBindTexture(GL_TEXTURE_BUFFER, tileTexture);
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 2);
+    glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glUniform1i(glGetUniformLocation(shader, "u_LightData"), firstUnit);
+    glUniform1i(glGetUniformLocation(shader, "u_LightTiles"), firstUnit + 1);
+    glUniform1i(glGetUniformLocation(shader, "u_LightIndices"), firstUnit + 2);
+    glUniform1i(glGetUniformLocation(shader, "u_TileSize"), TILE_SIZE);
+    glUniform1i(glGetUniformLocation(shader, "u_TilesX"), tilesX);
+}
+
+int load_light_file(const char* path, PointLight* out, int maxCount) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        std::cout << "Light file failed to load at path: " << path << std::endl;
+        return 0;
+    }
+    std::vector<unsigned char> bytes;
+    unsigned char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    fclose(f);
+
+    AssetView view;
+    view.data = bytes.data();
+    view.size = bytes.size();
+    return parse_light_file(view, out, maxCount);
+}
+
+int parse_light_file(const AssetView& file, PointLight* out, int maxCount) {
+    int count = 0;
+    size_t pos = 0;
+    while (count < maxCount && pos < file.size) {
+        // Copy one line out so sscanf never runs past the view
+        char line[256];
+        size_t len = 0;
+        while (pos < file.size && file.data[pos] != '\n') {
+            if (len < sizeof(line) - 1) line[len++] = (char)file.data[pos];
+            pos++;
+        }
+        line[len] = 0;
+        pos++;
+
+        PointLight light = {};
+        if (sscanf(line, " light %f %f %f %f %f %f %f",
+                   &light.position.x, &light.position.y, &light.position.z,
+                   &light.color.x, &light.color.y, &light.color.z, &light.range) == 7) {
+            light.isStatic = 1.0f;
+            out[count++] = light;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "arena.hpp"
+#include "asset_pack.hpp"
+
+// Base light level: App feeds it to retro.frag as u_AmbientColor, and hp3d_bake
+// scales it by AO into the baked vertex color. One value so the two can't drift.
+static const glm::vec3 AMBIENT_COLOR(0.2f, 0.2f, 0.3f);    // Dark blue
+
+// Matches the two RGBA32F texels the shader fetches per light
+struct PointLight {
+    glm::vec3 position;
+    float range;        // How far the light reaches
+    glm::vec3 color;
+    float isStatic;     // 1.0 = baked into the level by hp3d_bake, left out of BAKED_LIGHTING's lists
+};
+
+// Reads a level light file: one "light x y z  r g b  range" per line, '#' comments.
+// Every light in the file is static. Returns the number of lights written to out.
+int load_light_file(const char* path, PointLight* out, int maxCount);
+int parse_light_file(const AssetView& file, PointLight* out, int maxCount);
+
+// Clustered-lite forward lighting: lights are binned on the CPU into a coarse
+// screen-space tile grid, and retro.frag only loops over its own tile's list.
+//
+// Everything goes to the shader through texture buffers (GL 3.3 core):
+//   u_LightData    RGBA32F  2 texels per light (pos, range) (color, isStatic)
+//   u_LightTiles   RGBA32UI per tile (offset into index list, count, dynamic count, unused)
+//                           Each tile's list has its dynamic lights first.
+//   u_LightIndices R32UI    flat light index list
+struct LightGrid {
+    static constexpr int TILE_SIZE = 16;            // 320x240 -> 20x15 tiles
+    static constexpr int MAX_LIGHTS = 1024;
+    static constexpr int MAX_INDICES = 64 * 1024;   // Caps the index list at 256KB
+
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+
+    unsigned int lightBuffer, lightTexture;
+    unsigned int tileBuffer, tileTexture;
+    unsigned int indexBuffer, indexTexture;
+
+    // Stats from the last build()
+    int lightCount;
+    int indexCount;
+
+    void init(int target_width, int target_height);
+    void destroy();
+
+    // Follow a new render target size (buffers are re-specified every build anyway)
+    void resize(int target_width, int target_height);
+
+    // Bins the lights for this frame. Scratch memory comes from the frame arena.
+    void build(const PointLight* lights, int count,
+               const glm::mat4& view, const glm::mat4& projection, float nearPlane,
+               Arena& scratch);
+
+    // Binds the three buffers to texture units [firstUnit, firstUnit + 2]
+    void bind(unsigned int shader, int firstUnit) const;
+};
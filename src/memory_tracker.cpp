@@ -0,0 +1,115 @@
+#include "memory_tracker.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+uint64_t resource_key(MemObject kind, unsigned int name) {
+    return ((uint64_t)kind << 32) | name;
+}
+
+double to_mb(size_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+const char* mem_category_name(MemCategory category) {
+    switch (category) {
+        case MEM_VERTEX:  return "vertex";
+        case MEM_TEXTURE: return "texture";
+        case MEM_TARGET:  return "targets";
+        case MEM_STREAM:  return "stream";
+        case MEM_ARENA:   return "arenas";
+        case MEM_STAGING: return "staging";
+        default:          return "?";
+    }
+}
+
+size_t texture_bytes(int width, int height, int channels, bool mipmapped) {
+    size_t texel = channels >= 3 ? 4 : (size_t)channels;
+    size_t bytes = (size_t)width * height * texel;
+    return mipmapped ? bytes + bytes / 3 : bytes;
+}
+
+void MemoryTracker::track(MemObject kind, unsigned int name, MemCategory category, size_t size, const char* owner) {
+    Resource& res = resources[resource_key(kind, name)];
+    if (!res.owner.empty()) add(res.category, res.owner.c_str(), -(int64_t)res.bytes);
+    res = { category, owner, size };
+    add(category, owner, (int64_t)size);
+}
+
+void MemoryTracker::release(MemObject kind, unsigned int name) {
+    auto it = resources.find(resource_key(kind, name));
+    if (it == resources.end()) return;
+    add(it->second.category, it->second.owner.c_str(), -(int64_t)it->second.bytes);
+    resources.erase(it);
+}
+
+void MemoryTracker::watch_arena(const char* name, const Arena& arena, MemCategory category) {
+    arenas.push_back({ name, &arena, category, false, 0, 0 });
+}
+
+void MemoryTracker::set_arena_loading(const Arena& arena, bool loading) {
+    for (WatchedArena& watched : arenas) {
+        if (watched.arena == &arena) watched.loading = loading;
+    }
+}
+
+size_t MemoryTracker::owner_bytes(const char* owner, MemCategory category) const {
+    for (const OwnerTotal& total : owners) {
+        if (total.owner == owner) return total.bytes[category];
+    }
+    return 0;
+}
+
+void MemoryTracker::add(MemCategory category, const char* owner, int64_t delta) {
+    bytes[category] += delta;
+    if (bytes[category] > peak[category]) peak[category] = bytes[category];
+
+    for (OwnerTotal& total : owners) {
+        if (total.owner == owner) {
+            total.bytes[category] += delta;
+            return;
+        }
+    }
+    OwnerTotal total = { owner, {} };
+    total.bytes[category] = delta;
+    owners.push_back(total);
+}
+
+void MemoryTracker::update() {
+    // Arenas: what's in use right now (their reserve is fixed and known up front).
+    // An arena a level is loading into belongs to the worker, so it isn't read.
+    bytes[MEM_ARENA] = 0;
+    bytes[MEM_STAGING] = 0;
+    for (WatchedArena& watched : arenas) {
+        if (!watched.loading) {
+            watched.used = watched.arena->offset;
+            watched.peak = watched.arena->peak;
+        }
+        bytes[watched.category] += watched.used;
+    }
+    for (MemCategory category : { MEM_ARENA, MEM_STAGING }) {
+        if (bytes[category] > peak[category]) peak[category] = bytes[category];
+    }
+
+    for (int c = 0; c < MEM_CATEGORY_COUNT; ++c) {
+        bool over = budget[c] > 0 && bytes[c] > budget[c];
+        if (over != overBudget[c]) {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(2) << "[memory] " << mem_category_name((MemCategory)c)
+                 << (over ? " OVER" : " back under") << " budget: " << to_mb(bytes[c]) << " / " << to_mb(budget[c])
+                 << " MB";
+            std::cout << line.str() << std::endl;
+        }
+        overBudget[c] = over;
+    }
+}
+
+MemoryTracker& memory_tracker() {
+    static MemoryTracker tracker;
+    return tracker;
+}
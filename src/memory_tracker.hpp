@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+
+// What the bytes are for. Budgets and the overlay work per category.
+enum MemCategory {
+    MEM_VERTEX,     // Static VBOs (level, floor, crowd rest data, sky cube)
+    MEM_TEXTURE,    // Sampled textures, per owner (app or level name)
+    MEM_TARGET,     // Render targets (color + depth)
+    MEM_STREAM,     // Buffers re-specified every frame (crowd skinning, light grid)
+    MEM_ARENA,      // CPU arenas: app, levels, frame
+    MEM_STAGING,    // The staging arena (file bytes on their way to the GPU)
+    MEM_CATEGORY_COUNT
+};
+
+enum MemObject {
+    MEM_GL_BUFFER,
+    MEM_GL_TEXTURE,
+    MEM_GL_RENDERBUFFER,
+};
+
+const char* mem_category_name(MemCategory category);
+
+// Approximate driver-side size. RGB is stored padded to 4 bytes on every driver we
+// care about; a full mip chain adds a third.
+size_t texture_bytes(int width, int height, int channels, bool mipmapped);
+
+// Resource accounting. GL objects are recorded where they're created and dropped
+// where they're deleted; arenas are watched and sampled in update().
+// Main thread only.
+struct MemoryTracker {
+    struct Resource {
+        MemCategory category;
+        std::string owner;      // "app" or a Level's owner, copied: a slot's name changes per load
+        size_t bytes;
+    };
+
+    struct OwnerTotal {
+        std::string owner;
+        size_t bytes[MEM_CATEGORY_COUNT];
+    };
+
+    struct WatchedArena {
+        const char* name;
+        const Arena* arena;
+        MemCategory category;
+        bool loading;       // A worker thread owns the arena: not sampled, used keeps its last value
+        size_t used;        // offset as of the last update()
+        size_t peak;        // Arena::peak as of the last update()
+    };
+
+    std::unordered_map<uint64_t, Resource> resources;   // Key: MemObject << 32 | GL name
+    std::vector<OwnerTotal> owners;
+    std::vector<WatchedArena> arenas;
+
+    size_t bytes[MEM_CATEGORY_COUNT] = {};
+    size_t peak[MEM_CATEGORY_COUNT] = {};      // High-water mark since startup
+    size_t budget[MEM_CATEGORY_COUNT] = {};     // 0 = unlimited
+    bool overBudget[MEM_CATEGORY_COUNT] = {};
+
+    // Tracking the same object again replaces its size (re-specified buffers)
+    void track(MemObject kind, unsigned int name, MemCategory category, size_t size, const char* owner);
+    void release(MemObject kind, unsigned int name);
+
+    void watch_arena(const char* name, const Arena& arena, MemCategory category);
+    // Set before handing the arena to a worker, cleared once the worker is done with it
+    void set_arena_loading(const Arena& arena, bool loading);
+    void set_budget(MemCategory category, size_t maxBytes) { budget[category] = maxBytes; }
+
+    size_t owner_bytes(const char* owner, MemCategory category) const;
+
+    // Samples the arenas and logs budget crossings (once per crossing, both ways)
+    void update();
+
+private:
+    void add(MemCategory category, const char* owner, int64_t delta);
+};
+
+MemoryTracker& memory_tracker();
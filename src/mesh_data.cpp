@@ -0,0 +1,270 @@
+#include "mesh_data.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+namespace {
+
+const char kBakedMagic[4] = { 'H', 'P', 'M', '1' };
+
+bool is_sky_material(const std::string& name) {
+    return name.rfind("night_03_", 0) == 0;
+}
+
+// istream over an AssetView, no copy
+struct ViewStreamBuf : std::streambuf {
+    explicit ViewStreamBuf(const AssetView& view) {
+        char* p = (char*)view.data;
+        setg(p, p, p + view.size);
+    }
+};
+
+// Resolves "mtllib" through the loader instead of the filesystem
+class ViewMaterialReader : public tinyobj::MaterialReader {
+public:
+    ViewMaterialReader(const std::string& baseDir, const MeshFileLoader& loadFile)
+        : m_BaseDir(baseDir), m_LoadFile(loadFile) {}
+
+    bool operator()(const std::string& matId, std::vector<tinyobj::material_t>* materials,
+                    std::map<std::string, int>* matMap, std::string* warn, std::string* err) override {
+        AssetView view;
+        if (!m_LoadFile(m_BaseDir + matId, view)) {
+            if (warn) *warn += "Material file [ " + matId + " ] not found.\n";
+            return false;
+        }
+        ViewStreamBuf buf(view);
+        std::istream in(&buf);
+        tinyobj::LoadMtl(matMap, materials, &in, warn, err);
+        return true;
+    }
+
+private:
+    std::string m_BaseDir;
+    const MeshFileLoader& m_LoadFile;
+};
+
+void bucket_obj(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes,
+                const std::vector<tinyobj::material_t>& materials, MeshData& out) {
+    // 3. Group Geometry by Material
+    // Map: Material Index -> List of Floats (Vertex Data)
+    // We use a map so we can blindly throw triangles into buckets
+    std::map<int, std::vector<float>> sortedGeometry;
+
+    // Loop over all shapes (objects in the file)
+    for (const auto& shape : shapes) {
+        // Loop over all faces (triangles)
+        size_t index_offset = 0;
+        for (size_t f = 0; f < shape.mesh.num_face_vertices.size(); f++) {
+
+            // Get the material ID for this specific face
+            int currentMaterialId = shape.mesh.material_ids[f];
+
+            // If the mesh has no material (-1), group it into a default bucket (0)
+            if (currentMaterialId < 0) currentMaterialId = 0;
+
+            std::vector<float>& bucket = sortedGeometry[currentMaterialId];
+
+            // Get the 3 vertices of this face
+            for (size_t v = 0; v < 3; v++) {
+                tinyobj::index_t idx = shape.mesh.indices[index_offset + v];
+
+                // --- POSITIONS ---
+                bucket.push_back(attrib.vertices[3 * idx.vertex_index + 0]);
+                bucket.push_back(attrib.vertices[3 * idx.vertex_index + 1]);
+                bucket.push_back(attrib.vertices[3 * idx.vertex_index + 2]);
+
+                // --- TEXCOORDS ---
+                if (idx.texcoord_index >= 0) {
+                    bucket.push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
+                    bucket.push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
+                } else {
+                    bucket.push_back(0.0f);
+                    bucket.push_back(0.0f);
+                }
+
+                if (idx.normal_index >= 0) {
+                    bucket.push_back(attrib.normals[3 * idx.normal_index + 0]);
+                    bucket.push_back(attrib.normals[3 * idx.normal_index + 1]);
+                    bucket.push_back(attrib.normals[3 * idx.normal_index + 2]);
+                } else {
+                    // Fallback if OBJ has no normals (Up vector)
+                    bucket.push_back(0.0f);
+                    bucket.push_back(1.0f);
+                    bucket.push_back(0.0f);
+                }
+            }
+            index_offset += 3;
+        }
+    }
+
+    // 4. One bucket per material group
+    out.stride = MeshData::MESH_STRIDE;
+    out.buckets.clear();
+    for (auto& [matID, data] : sortedGeometry) {
+        MeshData::Bucket bucket;
+        if (matID < (int)materials.size()) {
+            // Sky box faces are drawn by the Skybox as one cubemap, not as six textured buckets
+            if (is_sky_material(materials[matID].name)) continue;
+            bucket.material = materials[matID].name;
+            bucket.texture = materials[matID].diffuse_texname;
+        }
+        bucket.vertices = std::move(data);
+        out.buckets.push_back(std::move(bucket));
+    }
+}
+
+} // namespace
+
+std::string mesh_base_dir(const char* path) {
+    std::string baseDir = path;
+    if (baseDir.find_last_of("/\\") != std::string::npos) {
+        return baseDir.substr(0, baseDir.find_last_of("/\\") + 1);
+    }
+    return "";
+}
+
+bool load_obj_mesh(const char* objPath, MeshData& out) {
+    // 1. TinyObj Loader Variables
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    // Get the base directory of the OBJ so we can find textures next to it
+    std::string baseDir = mesh_base_dir(objPath);
+
+    // 2. Load the OBJ and the MTL
+    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath, baseDir.c_str());
+
+    if (!warn.empty()) std::cout << "OBJ Warning: " << warn << std::endl;
+    if (!err.empty()) std::cerr << "OBJ Error: " << err << std::endl;
+    if (!ret) return false;
+
+    bucket_obj(attrib, shapes, materials, out);
+    return true;
+}
+
+bool load_obj_mesh(const char* objPath, const AssetView& obj, const MeshFileLoader& loadFile, MeshData& out,
+                   ObjLoadTimings* timings) {
+    using Clock = std::chrono::steady_clock;
+    auto parseStart = Clock::now();
+
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn, err;
+
+    ViewStreamBuf buf(obj);
+    std::istream in(&buf);
+    ViewMaterialReader readMaterial(mesh_base_dir(objPath), loadFile);
+    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &in, &readMaterial);
+    auto bucketStart = Clock::now();
+
+    if (!warn.empty()) std::cout << "OBJ Warning: " << warn << std::endl;
+    if (!err.empty()) std::cerr << "OBJ Error: " << err << std::endl;
+    if (!ret) return false;
+
+    bucket_obj(attrib, shapes, materials, out);
+    if (timings) {
+        timings->parseMs = std::chrono::duration<double, std::milli>(bucketStart - parseStart).count();
+        timings->bucketMs = std::chrono::duration<double, std::milli>(Clock::now() - bucketStart).count();
+    }
+    return true;
+}
+
+// --- Baked mesh file ---
+// magic "HPM1" | u32 stride | u32 bucketCount
+// per bucket: u32 len + material | u32 len + texture | u32 floatCount + floats
+
+bool save_baked_mesh(const char* path, const MeshData& mesh) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        std::cout << "Baked mesh failed to open for writing: " << path << std::endl;
+        return false;
+    }
+
+    auto write_u32 = [f](uint32_t v) { fwrite(&v, sizeof(v), 1, f); };
+    auto write_str = [&](const std::string& s) {
+        write_u32((uint32_t)s.size());
+        fwrite(s.data(), 1, s.size(), f);
+    };
+
+    fwrite(kBakedMagic, 1, 4, f);
+    write_u32((uint32_t)mesh.stride);
+    write_u32((uint32_t)mesh.buckets.size());
+    for (const auto& bucket : mesh.buckets) {
+        write_str(bucket.material);
+        write_str(bucket.texture);
+        write_u32((uint32_t)bucket.vertices.size());
+        fwrite(bucket.vertices.data(), sizeof(float), bucket.vertices.size(), f);
+    }
+
+    bool ok = ferror(f) == 0;
+    fclose(f);
+    return ok;
+}
+
+bool load_baked_mesh(const char* path, const AssetView& file, MeshData& out) {
+    const unsigned char* cursor = file.data;
+    const unsigned char* end = file.data + file.size;
+
+    bool ok = true;
+    auto read_bytes = [&](void* dst, size_t n) {
+        if (!ok || (size_t)(end - cursor) < n) { ok = false; return; }
+        memcpy(dst, cursor, n);
+        cursor += n;
+    };
+    auto read_u32 = [&]() {
+        uint32_t v = 0;
+        read_bytes(&v, sizeof(v));
+        return v;
+    };
+    auto read_str = [&]() {
+        uint32_t len = read_u32();
+        if (!ok || (size_t)(end - cursor) < len) { ok = false; return std::string(); }
+        std::string s(len, '\0');
+        read_bytes(s.data(), s.size());
+        return s;
+    };
+
+    char magic[4] = {};
+    read_bytes(magic, 4);
+    if (!ok || memcmp(magic, kBakedMagic, 4) != 0) {
+        std::cout << "Not a baked mesh: " << path << std::endl;
+        return false;
+    }
+
+    // upload_submesh divides by the stride and picks the attribute layout from it
+    uint32_t stride = read_u32();
+    if (ok && stride != MeshData::MESH_STRIDE && stride != MeshData::MESH_BAKED_STRIDE) {
+        std::cout << "Baked mesh has unsupported stride " << stride << ": " << path << std::endl;
+        return false;
+    }
+    out.stride = (int)stride;
+    uint32_t bucketCount = read_u32();
+    out.buckets.clear();
+    for (uint32_t i = 0; ok && i < bucketCount; ++i) {
+        MeshData::Bucket bucket;
+        bucket.material = read_str();
+        bucket.texture = read_str();
+        uint32_t floatCount = read_u32();
+        if (ok && floatCount % stride != 0) {
+            std::cout << "Baked mesh bucket " << i << " is not a whole number of vertices: " << path << std::endl;
+            return false;
+        }
+        if (!ok || (size_t)(end - cursor) < (size_t)floatCount * sizeof(float)) { ok = false; break; }
+        bucket.vertices.resize(floatCount);
+        read_bytes(bucket.vertices.data(), floatCount * sizeof(float));
+        out.buckets.push_back(std::move(bucket));
+    }
+
+    if (!ok) std::cout << "Baked mesh is truncated: " << path << std::endl;
+    return ok;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "asset_pack.hpp"
+
+// CPU-side mesh, no GL. One bucket of interleaved triangle vertices per material,
+// exactly what App::load_model uploads as SubMeshes.
+//
+// Vertex layout (floats):
+//   MESH_STRIDE        pos(3) uv(2) normal(3)
+//   MESH_BAKED_STRIDE  pos(3) uv(2) normal(3) baked rgb(3)
+struct MeshData {
+    static constexpr int MESH_STRIDE = 8;
+    static constexpr int MESH_BAKED_STRIDE = 11;
+
+    struct Bucket {
+        std::string material;       // MTL material name
+        std::string texture;        // Diffuse texture, relative to the mesh's directory ("" = none)
+        std::vector<float> vertices;
+    };
+
+    int stride = MESH_STRIDE;
+    std::vector<Bucket> buckets;
+
+    bool baked() const { return stride == MESH_BAKED_STRIDE; }
+};
+
+// Fetches a file the OBJ references (its MTL), by path
+using MeshFileLoader = std::function<bool(const std::string& path, AssetView& out)>;
+
+// Parses an OBJ/MTL pair and buckets its triangles by material.
+// Sky box faces (night_03_*) are dropped, the Skybox pass draws them.
+bool load_obj_mesh(const char* objPath, MeshData& out);
+
+// Where load_obj_mesh spends its time (hp3d_bench)
+struct ObjLoadTimings {
+    double parseMs = 0.0;   // tinyobj: OBJ/MTL text -> attributes, shapes, materials
+    double bucketMs = 0.0;  // Faces -> interleaved per-material buckets
+};
+
+// Same, from bytes already in memory (asset pack / staging). objPath only names
+// the file and locates the MTL next to it.
+bool load_obj_mesh(const char* objPath, const AssetView& obj, const MeshFileLoader& loadFile, MeshData& out,
+                   ObjLoadTimings* timings = nullptr);
+
+// Baked mesh (.hpmesh): the OBJ buckets plus a per-vertex baked color, written by hp3d_bake.
+bool load_baked_mesh(const char* path, const AssetView& file, MeshData& out);
+bool save_baked_mesh(const char* path, const MeshData& mesh);
+
+// Directory part of a path including the trailing slash ("" if none)
+std::string mesh_base_dir(const char* path);
@@ -0,0 +1,161 @@
+#include "overlay.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <glad/glad.h>
+
+#include "memory_tracker.hpp"
+
+namespace {
+
+// ASCII 32..95, 3x5. 15 bits per glyph: rows top to bottom, 3 bits per row, MSB = left.
+const unsigned short kFont[64] = {
+    0x0000, 0x2482, 0x5A00, 0x5F7D, 0x3C9E, 0x52A5, 0x2AAB, 0x2400,  //  !"#$%&'
+    0x1491, 0x4494, 0x0AA8, 0x05D0, 0x0014, 0x01C0, 0x0002, 0x12A4,  // ()*+,-./
+    0x7B6F, 0x2C97, 0x73E7, 0x72CF, 0x5BC9, 0x79CF, 0x79EF, 0x7292,  // 01234567
+    0x7BEF, 0x7BCF, 0x0410, 0x0414, 0x1511, 0x0E38, 0x4454, 0x72C2,  // 89:;<=>?
+    0x2BE3, 0x2BED, 0x6BAE, 0x3923, 0x6B6E, 0x79A7, 0x79A4, 0x396B,  // @ABCDEFG
+    0x5BED, 0x7497, 0x126A, 0x5BAD, 0x4927, 0x5FED, 0x6B6D, 0x2B6A,  // HIJKLMNO
+    0x6BA4, 0x2B73, 0x6BAD, 0x388E, 0x7492, 0x5B6B, 0x5B52, 0x5BFD,  // PQRSTUVW
+    0x5AAD, 0x5A92, 0x72A7, 0x3493, 0x4889, 0x6496, 0x2A00, 0x0007,  // XYZ[\]^_
+};
+
+// Atlas: 16x4 glyph cells of GLYPH_W x GLYPH_H texels
+const int kAtlasCols = 16;
+const int kAtlasW = kAtlasCols * StatsOverlay::GLYPH_W;
+const int kAtlasH = 4 * StatsOverlay::GLYPH_H;
+
+} // namespace
+
+void StatsOverlay::init(unsigned int shader_program) {
+    shader = shader_program;
+    resolutionLoc = glGetUniformLocation(shader, "u_Resolution");
+    fontLoc = glGetUniformLocation(shader, "u_Font");
+
+    // --- 1. Expand the bit font into an R8 atlas ---
+    unsigned char atlas[kAtlasW * kAtlasH] = {};
+    for (int g = 0; g < 64; ++g) {
+        int cellX = (g % kAtlasCols) * GLYPH_W;
+        int cellY = (g / kAtlasCols) * GLYPH_H;
+        for (int row = 0; row < GLYPH_H; ++row) {
+            for (int col = 0; col < GLYPH_W; ++col) {
+                int bit = (GLYPH_H - 1 - row) * GLYPH_W + (GLYPH_W - 1 - col);
+                if (kFont[g] & (1 << bit)) atlas[(cellY + row) * kAtlasW + cellX + col] = 255;
+            }
+        }
+    }
+
+    glGenTextures(1, &fontTexture);
+    glBindTexture(GL_TEXTURE_2D, fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, kAtlasW, kAtlasH, 0, GL_RED, GL_UNSIGNED_BYTE, atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    memory_tracker().track(MEM_GL_TEXTURE, fontTexture, MEM_TEXTURE, texture_bytes(kAtlasW, kAtlasH, 1, false), "app");
+
+    // --- 2. One streamed buffer, refilled every frame ---
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    size_t capacity = (size_t)MAX_QUADS * 6 * FLOATS_PER_VERTEX * sizeof(float);
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    memory_tracker().track(MEM_GL_BUFFER, vbo, MEM_STREAM, capacity, "app");
+
+    int stride = FLOATS_PER_VERTEX * sizeof(float);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (void*)(4 * sizeof(float)));
+    glBindVertexArray(0);
+}
+
+void StatsOverlay::destroy() {
+    memory_tracker().release(MEM_GL_TEXTURE, fontTexture);
+    memory_tracker().release(MEM_GL_BUFFER, vbo);
+    glDeleteTextures(1, &fontTexture);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteProgram(shader);
+}
+
+void StatsOverlay::begin(Arena& frameArena) {
+    arena = &frameArena;
+    vertices = nullptr;
+    quadCount = 0;
+}
+
+void StatsOverlay::quad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float text) {
+    if (quadCount == MAX_QUADS) return;
+    const float corners[6][4] = {
+        { x0, y0, u0, v0 }, { x1, y0, u1, v0 }, { x1, y1, u1, v1 },
+        { x0, y0, u0, v0 }, { x1, y1, u1, v1 }, { x0, y1, u0, v1 },
+    };
+    float* out = vertices + (size_t)quadCount * 6 * FLOATS_PER_VERTEX;
+    for (const auto& c : corners) {
+        *out++ = c[0]; *out++ = c[1]; *out++ = c[2]; *out++ = c[3]; *out++ = text;
+    }
+    quadCount++;
+}
+
+void StatsOverlay::print(int x, int y, const char* fmt, ...) {
+    if (!visible || !arena) return;
+    // Vertex space for the whole frame, taken on the first line
+    if (!vertices) vertices = arena->alloc_array<float>((size_t)MAX_QUADS * 6 * FLOATS_PER_VERTEX);
+
+    char* line = arena->alloc_array<char>(128);
+    va_list args;
+    va_start(args, fmt);
+    int length = vsnprintf(line, 128, fmt, args);
+    va_end(args);
+    if (length <= 0) return;
+    if (length > 127) length = 127;
+
+    // Dark strip behind the line so it reads over anything
+    quad((float)x - 1, (float)y - 1, (float)(x + length * CELL_W), (float)(y + CELL_H), 0, 0, 0, 0, 0.0f);
+
+    for (int i = 0; i < length; ++i) {
+        int c = (unsigned char)line[i];
+        if (c >= 'a' && c <= 'z') c -= 32;
+        if (c < 32 || c > 95) c = '?';
+        if (c == ' ') continue;
+        int g = c - 32;
+        float u0 = (float)((g % kAtlasCols) * GLYPH_W) / kAtlasW;
+        float v0 = (float)((g / kAtlasCols) * GLYPH_H) / kAtlasH;
+        float u1 = u0 + (float)GLYPH_W / kAtlasW;
+        float v1 = v0 + (float)GLYPH_H / kAtlasH;
+        float px = (float)(x + i * CELL_W);
+        quad(px, (float)y, px + GLYPH_W, (float)(y + GLYPH_H), u0, v0, u1, v1, 1.0f);
+    }
+}
+
+int StatsOverlay::draw(int targetWidth, int targetHeight) {
+    if (!visible || quadCount == 0) return 0;
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    // Orphan, then fill: never waits on last frame's draw
+    size_t capacity = (size_t)MAX_QUADS * 6 * FLOATS_PER_VERTEX * sizeof(float);
+    glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (size_t)quadCount * 6 * FLOATS_PER_VERTEX * sizeof(float), vertices);
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(shader);
+    glUniform2f(resolutionLoc, (float)targetWidth, (float)targetHeight);
+    glUniform1i(fontLoc, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, fontTexture);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, quadCount * 6);
+
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    return 1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "arena.hpp"
+
+// Debug text drawn into the internal (FBO) pass with a built-in 3x5 pixel font,
+// so it gets the same crunchy upscale as the game.
+//
+// Per frame: begin() with the frame arena, print() lines, draw() once. Text and
+// vertices live in the frame arena and go up in one buffer, one draw call.
+struct StatsOverlay {
+    static constexpr int GLYPH_W = 3;
+    static constexpr int GLYPH_H = 5;
+    static constexpr int CELL_W = GLYPH_W + 1;  // 1px spacing
+    static constexpr int CELL_H = GLYPH_H + 1;
+    static constexpr int MAX_QUADS = 1024;
+    static constexpr int FLOATS_PER_VERTEX = 5; // pos(2) uv(2) text/background(1)
+
+    unsigned int vao;
+    unsigned int vbo;
+    unsigned int fontTexture;
+    unsigned int shader;
+    int resolutionLoc;
+    int fontLoc;
+
+    bool visible = false;
+
+    // This frame's geometry (frame arena)
+    Arena* arena = nullptr;
+    float* vertices = nullptr;
+    int quadCount = 0;
+
+    void init(unsigned int shader_program);
+    void destroy();
+
+    void begin(Arena& frameArena);
+    // Pixel coordinates, top-left origin. Lower case is drawn as upper case.
+    void print(int x, int y, const char* fmt, ...);
+    // Returns the draw calls issued (0 or 1)
+    int draw(int targetWidth, int targetHeight);
+
+private:
+    void quad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, float text);
+};
@@ -0,0 +1,188 @@
+#include "resolution.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <glad/glad.h>
+
+#include "memory_tracker.hpp"
+
+namespace {
+
+// All 4:3, so the projection never changes. 320x240 is the reference look;
+// the two below are for software-rendered clients, 640x480 for strong machines.
+const int kTargetSizes[ResolutionScaler::TARGET_COUNT][2] = {
+    { 192, 144 },
+    { 256, 192 },
+    { 320, 240 },
+    { 640, 480 },
+};
+
+// Mesa's llvmpipe/softpipe, SwiftShader, Windows' GDI fallback: the thin clients
+bool is_software_renderer() {
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    if (!renderer) return false;
+    for (const char* name : { "llvmpipe", "softpipe", "SwiftShader", "GDI Generic", "Software Rasterizer" }) {
+        if (strstr(renderer, name)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool RenderTarget::init(int target_width, int target_height) {
+    width = target_width;
+    height = target_height;
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    glGenTextures(1, &color);
+    glBindTexture(GL_TEXTURE_2D, color);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+
+    // CRITICAL: Use GL_NEAREST for that crunchy pixelated look, at every size.
+    // GL_LINEAR would make it blurry (N64 style).
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+    memory_tracker().track(MEM_GL_TEXTURE, color, MEM_TARGET, texture_bytes(width, height, 3, false), "app");
+    memory_tracker().track(MEM_GL_RENDERBUFFER, depth, MEM_TARGET, (size_t)width * height * 4, "app");
+
+    bool ok = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (!ok) std::cout << "ERROR::FRAMEBUFFER:: " << width << "x" << height << " framebuffer is not complete!" << std::endl;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return ok;
+}
+
+void RenderTarget::destroy() {
+    memory_tracker().release(MEM_GL_TEXTURE, color);
+    memory_tracker().release(MEM_GL_RENDERBUFFER, depth);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteTextures(1, &color);
+    glDeleteRenderbuffers(1, &depth);
+    fbo = color = depth = 0;
+}
+
+bool ResolutionScaler::init() {
+    bool ok = true;
+    for (int i = 0; i < TARGET_COUNT; ++i) {
+        ok = targets[i].init(kTargetSizes[i][0], kTargetSizes[i][1]) && ok;
+    }
+
+    // Timer queries are core in 3.3, but some software drivers report 0 bits
+    GLint bits = 0;
+    glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &bits);
+    queriesSupported = bits > 0;
+    glGenQueries(QUERY_RING, queries);
+    for (int i = 0; i < QUERY_RING; ++i) queryPending[i] = false;
+    if (!queriesSupported) {
+        enabled = false;
+        std::cout << "[resolution] GPU timer queries unavailable, fixed at "
+                  << target().width << "x" << target().height << std::endl;
+    }
+
+    // A software rasterizer never has the headroom for hi-res: auto only scales down
+    if (is_software_renderer()) {
+        maxTarget = DEFAULT_TARGET;
+        std::cout << "[resolution] software renderer, auto capped at "
+                  << targets[maxTarget].width << "x" << targets[maxTarget].height << std::endl;
+    }
+    return ok;
+}
+
+void ResolutionScaler::destroy() {
+    glDeleteQueries(QUERY_RING, queries);
+    for (auto& t : targets) t.destroy();
+}
+
+void ResolutionScaler::begin_frame() {
+    if (!queriesSupported) return;
+    // Slot still in flight (GPU more than QUERY_RING frames behind): skip timing this frame
+    if (queryPending[queryIndex]) return;
+    glBeginQuery(GL_TIME_ELAPSED, queries[queryIndex]);
+}
+
+void ResolutionScaler::end_frame() {
+    if (!queriesSupported) return;
+    if (!queryPending[queryIndex]) {
+        glEndQuery(GL_TIME_ELAPSED);
+        queryPending[queryIndex] = true;
+    }
+    queryIndex = (queryIndex + 1) % QUERY_RING;
+    read_queries();
+}
+
+void ResolutionScaler::read_queries() {
+    // Oldest first, stop at the first one that isn't done (they complete in order)
+    for (int n = 0; n < QUERY_RING; ++n) {
+        int i = (queryIndex + n) % QUERY_RING;
+        if (!queryPending[i]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[i], GL_QUERY_RESULT, &ns);
+        queryPending[i] = false;
+
+        lastGpuMs = (float)(ns / 1.0e6);
+        gpuMs = gpuMs == 0.0f ? lastGpuMs : gpuMs + (lastGpuMs - gpuMs) * 0.1f;
+        control();
+    }
+}
+
+void ResolutionScaler::control() {
+    if (!enabled) return;
+    if (cooldown > 0) {
+        cooldown--;
+        return;
+    }
+
+    // Down reacts to the raw sample (a hitch shouldn't wait for the average),
+    // up uses the smoothed time so one quiet frame doesn't trigger it
+    overFrames = lastGpuMs > budgetMs ? overFrames + 1 : 0;
+
+    // Cost scales roughly with pixel count
+    bool canGoUp = current < maxTarget;
+    float predictedUpMs = 0.0f;
+    if (canGoUp) {
+        const RenderTarget& up = targets[current + 1];
+        float areaRatio = (float)(up.width * up.height) / (float)(target().width * target().height);
+        predictedUpMs = gpuMs * areaRatio;
+    }
+    underFrames = canGoUp && predictedUpMs < budgetMs * UP_HEADROOM ? underFrames + 1 : 0;
+
+    char reason[96];
+    if (overFrames >= DOWN_FRAMES && current > 0) {
+        snprintf(reason, sizeof(reason), "gpu %.2f ms > budget %.2f ms", lastGpuMs, budgetMs);
+        set_target(current - 1, reason);
+    } else if (underFrames >= UP_FRAMES) {
+        snprintf(reason, sizeof(reason), "gpu %.2f ms, predicted %.2f ms < budget %.2f ms", gpuMs, predictedUpMs, budgetMs);
+        set_target(current + 1, reason);
+    }
+}
+
+void ResolutionScaler::set_target(int index, const char* reason) {
+    if (index < 0 || index >= TARGET_COUNT) return;
+    overFrames = underFrames = 0;
+    cooldown = COOLDOWN_FRAMES;
+    if (index == current) return;
+
+    const RenderTarget& from = target();
+    current = index;
+    std::cout << "[resolution] " << from.width << "x" << from.height << " -> "
+              << target().width << "x" << target().height << " (" << reason << ")" << std::endl;
+    // The smoothed time was measured at the old size
+    gpuMs = 0.0f;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+// One internal render target: color texture (NEAREST, for the crunchy upscale) + depth
+struct RenderTarget {
+    int width;
+    int height;
+    unsigned int fbo;
+    unsigned int color;
+    unsigned int depth;
+
+    bool init(int target_width, int target_height);
+    void destroy();
+};
+
+// Dynamic internal resolution. Every target is allocated up front so a switch
+// is just a different FBO bind, never a reallocation mid-game.
+//
+// GPU time comes from GL_TIME_ELAPSED queries in a small ring, read back a few
+// frames late so the CPU never waits on them. The controller steps one level at
+// a time and only after the time has stayed over/under budget for a while, with
+// a cooldown after each switch, so it doesn't flicker between two sizes.
+struct ResolutionScaler {
+    static constexpr int TARGET_COUNT = 4;
+    static constexpr int DEFAULT_TARGET = 2;    // 320x240, the original look
+    static constexpr int QUERY_RING = 4;
+
+    static constexpr int DOWN_FRAMES = 15;      // Consecutive over-budget frames before stepping down
+    static constexpr int UP_FRAMES = 120;       // Consecutive frames with headroom before stepping up
+    static constexpr int COOLDOWN_FRAMES = 60;  // After a switch, let the new size settle
+    static constexpr float UP_HEADROOM = 0.75f; // Step up only if the predicted time fits in this much budget
+
+    RenderTarget targets[TARGET_COUNT];
+    int current = DEFAULT_TARGET;
+    bool enabled = true;
+    int maxTarget = TARGET_COUNT - 1;   // Highest auto goes; DEFAULT_TARGET on software renderers (F8 still can)
+
+    float budgetMs = 16.6f;     // GPU time we aim to stay under
+    float gpuMs = 0.0f;         // Smoothed measured GPU time
+    float lastGpuMs = 0.0f;     // Most recent raw sample
+
+    unsigned int queries[QUERY_RING];
+    bool queryPending[QUERY_RING];
+    int queryIndex = 0;
+    bool queriesSupported = false;
+
+    int overFrames = 0;
+    int underFrames = 0;
+    int cooldown = 0;
+
+    bool init();
+    void destroy();
+
+    const RenderTarget& target() const { return targets[current]; }
+
+    // Bracket everything the GPU does for a frame
+    void begin_frame();
+    void end_frame();
+
+    // Manual override (also used when disabling): jumps straight to index
+    void set_target(int index, const char* reason);
+
+private:
+    void read_queries();
+    void control();
+};
@@ -0,0 +1,120 @@
+#include "skinning.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HP3D_SKIN_SSE 1
+#include <emmintrin.h>
+#endif
+
+void skin_vertices_scalar(const SkinSource* src, int count, const float* palette, float* out) {
+    for (int v = 0; v < count; ++v) {
+        const SkinSource& s = src[v];
+
+        // Blend the 4 columns of the influencing matrices
+        float m[16] = {};
+        for (int i = 0; i < 4; ++i) {
+            const float* joint = palette + s.joints[i] * 16;
+            float w = s.weights[i];
+            for (int k = 0; k < 16; ++k) m[k] += joint[k] * w;
+        }
+
+        const float* p = s.position;
+        const float* n = s.normal;
+        float* dst = out + v * SKINNED_FLOATS;
+        for (int r = 0; r < 3; ++r) {
+            dst[r]     = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+            dst[4 + r] = m[r] * n[0] + m[4 + r] * n[1] + m[8 + r] * n[2];
+        }
+        dst[3] = 0.0f;
+        dst[7] = 0.0f;
+    }
+}
+
+#ifdef HP3D_SKIN_SSE
+
+void skin_vertices(const SkinSource* src, int count, const float* palette, float* out) {
+    for (int v = 0; v < count; ++v) {
+        const SkinSource& s = src[v];
+
+        __m128 c0 = _mm_setzero_ps();
+        __m128 c1 = _mm_setzero_ps();
+        __m128 c2 = _mm_setzero_ps();
+        __m128 c3 = _mm_setzero_ps();
+        for (int i = 0; i < 4; ++i) {
+            const float* joint = palette + s.joints[i] * 16;
+            __m128 w = _mm_set1_ps(s.weights[i]);
+            c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(joint + 0), w));
+            c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(joint + 4), w));
+            c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(joint + 8), w));
+            c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(joint + 12), w));
+        }
+
+        // Palette w lanes are zero, so the pads come out as zero for free
+        __m128 pos = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(s.position[0])), _mm_mul_ps(c1, _mm_set1_ps(s.position[1]))),
+            _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(s.position[2])), c3));
+        __m128 nrm = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(s.normal[0])), _mm_mul_ps(c1, _mm_set1_ps(s.normal[1]))),
+            _mm_mul_ps(c2, _mm_set1_ps(s.normal[2])));
+
+        float* dst = out + v * SKINNED_FLOATS;
+        _mm_storeu_ps(dst, pos);
+        _mm_storeu_ps(dst + 4, nrm);
+    }
+}
+
+#else
+
+void skin_vertices(const SkinSource* src, int count, const float* palette, float* out) {
+    skin_vertices_scalar(src, count, palette, out);
+}
+
+#endif
+
+void auto_skin_weights(const Skeleton& skeleton, SkinSource* verts, int count) {
+    int jointCount = skeleton.joint_count();
+
+    for (int v = 0; v < count; ++v) {
+        glm::vec3 p(verts[v].position[0], verts[v].position[1], verts[v].position[2]);
+
+        // Distance to each joint's closest owned bone (a joint can own several: chest -> neck, arms)
+        float dist[MAX_JOINTS];
+        int order[MAX_JOINTS];
+        for (int j = 0; j < jointCount; ++j) {
+            dist[j] = FLT_MAX;
+            order[j] = j;
+        }
+        for (int j = 0; j < jointCount; ++j) {
+            int owner = skeleton.parents[j] >= 0 ? skeleton.parents[j] : j;
+            glm::vec3 a = skeleton.bindPositions[owner];
+            glm::vec3 ab = skeleton.bindPositions[j] - a;
+            float len2 = glm::dot(ab, ab);
+            float t = len2 > 0.0f ? glm::clamp(glm::dot(p - a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+            dist[owner] = std::min(dist[owner], glm::length(p - (a + ab * t)));
+        }
+
+        // Leaf joints (head, hands, feet) own no bone, give them their own point
+        for (int j = 0; j < jointCount; ++j) {
+            if (dist[j] == FLT_MAX) dist[j] = glm::length(p - skeleton.bindPositions[j]);
+        }
+
+        int influences = std::min(jointCount, 4);
+        std::partial_sort(order, order + influences, order + jointCount,
+                          [&](int a, int b) { return dist[a] < dist[b]; });
+
+        // Inverse distance^4 keeps joints fairly rigid with a short blend at the seams
+        float w[4] = {};
+        float total = 0.0f;
+        for (int k = 0; k < influences; ++k) {
+            w[k] = 1.0f / (powf(dist[order[k]], 4.0f) + 1e-6f);
+            total += w[k];
+        }
+        for (int k = 0; k < 4; ++k) {
+            verts[v].weights[k] = k < influences ? w[k] / total : 0.0f;
+            verts[v].joints[k] = (unsigned char)(k < influences ? order[k] : 0);
+        }
+    }
+}
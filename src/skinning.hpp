@@ -0,0 +1,25 @@
+#pragma once
+
+#include "animation.hpp"
+
+// Bind-pose vertex for linear blend skinning
+struct SkinSource {
+    float position[4];          // xyz, 1
+    float normal[4];            // xyz, 0
+    float weights[4];
+    unsigned char joints[4];
+};
+
+// Skinned output: position (xyz, pad) + normal (xyz, pad), 32 bytes.
+// Streamed straight into the mapped VBO; UVs stay in a static buffer.
+static constexpr int SKINNED_FLOATS = 8;
+
+// Linear blend skinning with the 3x4 palette from compute_skin_matrices().
+// SSE when the compiler targets it, scalar otherwise.
+void skin_vertices(const SkinSource* src, int count, const float* palette, float* out);
+void skin_vertices_scalar(const SkinSource* src, int count, const float* palette, float* out);
+
+// No authored weights ship with our meshes, so derive them from the bind skeleton:
+// each vertex takes up to 4 of the nearest bones (bone = parent -> joint segment,
+// owned by the parent), weighted by inverse distance.
+void auto_skin_weights(const Skeleton& skeleton, SkinSource* verts, int count);
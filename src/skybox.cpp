@@ -0,0 +1,159 @@
+#include "skybox.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "level.hpp"
+#include "memory_tracker.hpp"
+#include "stb_image.h"
+
+namespace {
+
+struct DecodedFace {
+    unsigned char* data;
+    int width;
+    int height;
+};
+
+// 36 verts, one unit cube. Winding doesn't matter, we never cull the sky.
+const float kCubeVertices[] = {
+    -1.0f,  1.0f, -1.0f,  -1.0f, -1.0f, -1.0f,   1.0f, -1.0f, -1.0f,
+     1.0f, -1.0f, -1.0f,   1.0f,  1.0f, -1.0f,  -1.0f,  1.0f, -1.0f,
+
+    -1.0f, -1.0f,  1.0f,  -1.0f, -1.0f, -1.0f,  -1.0f,  1.0f, -1.0f,
+    -1.0f,  1.0f, -1.0f,  -1.0f,  1.0f,  1.0f,  -1.0f, -1.0f,  1.0f,
+
+     1.0f, -1.0f, -1.0f,   1.0f, -1.0f,  1.0f,   1.0f,  1.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,   1.0f,  1.0f, -1.0f,   1.0f, -1.0f, -1.0f,
+
+    -1.0f, -1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,   1.0f,  1.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,   1.0f, -1.0f,  1.0f,  -1.0f, -1.0f,  1.0f,
+
+    -1.0f,  1.0f, -1.0f,   1.0f,  1.0f, -1.0f,   1.0f,  1.0f,  1.0f,
+     1.0f,  1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,  -1.0f,  1.0f, -1.0f,
+
+    -1.0f, -1.0f, -1.0f,  -1.0f, -1.0f,  1.0f,   1.0f, -1.0f, -1.0f,
+     1.0f, -1.0f, -1.0f,  -1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f
+};
+
+} // namespace
+
+bool decode_sky_faces(const AssetView files[6], Arena& arena, SkyFaces& out) {
+    // --- 1. Decode all six faces in parallel ---
+    // PNG decode dominates load time here, and the faces are independent.
+    // Cubemaps are not flipped (GL samples them with a top-left origin per face).
+    DecodedFace decoded[6] = {};
+    std::thread workers[6];
+    for (int i = 0; i < 6; ++i) {
+        workers[i] = std::thread([&decoded, files, i]() {
+            int channels;
+            stbi_set_flip_vertically_on_load_thread(false);
+            decoded[i].data = stbi_load_from_memory(files[i].data, (int)files[i].size,
+                                                    &decoded[i].width, &decoded[i].height, &channels, 3);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    // --- 2. Move into the arena (sequential: arenas aren't thread safe) ---
+    bool ok = true;
+    for (int i = 0; i < 6; ++i) {
+        if (!decoded[i].data) {
+            std::cout << "Skybox face " << i << " failed to decode" << std::endl;
+            ok = false;
+        } else if (decoded[i].width != decoded[0].width || decoded[i].height != decoded[0].height) {
+            std::cout << "Skybox face " << i << " size mismatch" << std::endl;
+            ok = false;
+        }
+    }
+    if (ok) {
+        size_t faceBytes = (size_t)decoded[0].width * decoded[0].height * 3;
+        out.width = decoded[0].width;
+        out.height = decoded[0].height;
+        for (int i = 0; i < 6; ++i) {
+            out.pixels[i] = arena.alloc_array<unsigned char>(faceBytes);
+            memcpy(out.pixels[i], decoded[i].data, faceBytes);
+        }
+    }
+    for (int i = 0; i < 6; ++i) stbi_image_free(decoded[i].data);
+    return ok;
+}
+
+unsigned int upload_cubemap(const SkyFaces& faces, const char* owner) {
+    // GL calls stay on the main thread
+    unsigned int cubemap;
+    glGenTextures(1, &cubemap);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < 6; ++i) {
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB,
+                     faces.width, faces.height, 0, GL_RGB, GL_UNSIGNED_BYTE, faces.pixels[i]);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    memory_tracker().track(MEM_GL_TEXTURE, cubemap, MEM_TEXTURE, 6 * texture_bytes(faces.width, faces.height, 3, false), owner);
+    gl_object_counts(owner).textures++;
+
+    // PS1 Style: Nearest, and clamp so the seams don't bleed
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    std::cout << "Loaded Skybox (" << faces.width << "x" << faces.height << " per face)" << std::endl;
+    return cubemap;
+}
+
+void Skybox::init(unsigned int shader_program) {
+    shader = shader_program;
+
+    // Cube geometry
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(kCubeVertices), kCubeVertices, GL_STATIC_DRAW);
+    memory_tracker().track(MEM_GL_BUFFER, vbo, MEM_VERTEX, sizeof(kCubeVertices), "app");
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    viewLoc = glGetUniformLocation(shader, "view");
+    projLoc = glGetUniformLocation(shader, "projection");
+    snapLoc = glGetUniformLocation(shader, "u_SnapResolution");
+    skyLoc  = glGetUniformLocation(shader, "u_Sky");
+}
+
+void Skybox::draw(unsigned int cubemap, const glm::mat4& view, const glm::mat4& projection, float snapW, float snapH) const {
+    // Strip translation: the sky is infinitely far away
+    glm::mat4 skyView = glm::mat4(glm::mat3(view));
+
+    // The vertex shader writes z = w, so depth is exactly 1.0.
+    // LEQUAL lets it pass only where the clear value is still in the depth buffer.
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+
+    glUseProgram(shader);
+    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(skyView));
+    glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+    glUniform2f(snapLoc, snapW, snapH);
+    glUniform1i(skyLoc, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_TRIANGLES, 0, 36);
+
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+}
+
+void Skybox::destroy() {
+    memory_tracker().release(MEM_GL_BUFFER, vbo);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteProgram(shader);
+    vbo = vao = shader = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "arena.hpp"
+#include "asset_pack.hpp"
+
+// Six decoded RGB faces, CPU only (safe to build off the main thread)
+struct SkyFaces {
+    unsigned char* pixels[6] = {};
+    int width = 0;
+    int height = 0;
+
+    bool valid() const { return pixels[0] != nullptr; }
+};
+
+// files[] are the encoded PNGs in GL cubemap order: +X, -X, +Y, -Y, +Z, -Z.
+// Pixels end up in arena.
+bool decode_sky_faces(const AssetView files[6], Arena& arena, SkyFaces& out);
+unsigned int upload_cubemap(const SkyFaces& faces, const char* owner);
+
+// Cubemap sky drawn as one unit cube pinned to the far plane.
+// Drawn last in the FBO pass so only pixels nothing else covered get shaded.
+// The cubemap itself belongs to the level, the cube and shader to the Skybox.
+struct Skybox {
+    unsigned int vao;
+    unsigned int vbo;
+    unsigned int shader;
+
+    // Cached uniform locations (looked up once in init)
+    int viewLoc;
+    int projLoc;
+    int snapLoc;
+    int skyLoc;
+
+    void init(unsigned int shader_program);
+    void draw(unsigned int cubemap, const glm::mat4& view, const glm::mat4& projection, float snapW, float snapH) const;
+    void destroy();
+};
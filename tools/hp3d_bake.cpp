@@ -0,0 +1,364 @@
+// hp3d_bake: offline static lighting for level meshes.
+//
+// Reads a level OBJ and its static light file, casts CPU rays against the level
+// itself for ambient occlusion and torch shadows, and writes a .hpmesh with the
+// result folded into a per-vertex color. retro.frag's BAKED_LIGHTING variant then
+// just multiplies the texture by it and adds dynamic lights on top.
+//
+// Usage:
+//   hp3d_bake <in.obj> <out.hpmesh> [lights] [--ao-rays N] [--ao-radius R] [--threads N]
+//
+// e.g. (from the build dir)
+//   ./hp3d_bake ../assets/levels/01/Adv1Willow.obj ../assets/levels/01/Adv1Willow.hpmesh
+//               ../assets/levels/01/Adv1Willow.lights
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "lights.hpp"
+#include "mesh_data.hpp"
+
+namespace {
+
+struct Settings {
+    int aoRays = 32;
+    float aoRadius = 4.0f;
+    int threads = 0; // 0 = hardware_concurrency
+};
+
+// ---------------------------------------------------------
+// BVH over the level triangles (occlusion queries only)
+// ---------------------------------------------------------
+struct Triangle {
+    glm::vec3 v0, e1, e2; // Vertex 0 + edges, ready for Moller-Trumbore
+};
+
+struct BVHNode {
+    glm::vec3 lo, hi;
+    int first;  // Leaf: first triangle. Inner: left child (right = left + 1)
+    int count;  // 0 for inner nodes
+};
+
+struct BVH {
+    static constexpr int MAX_DEPTH = 63;    // occluded()'s stack holds MAX_DEPTH + 1 nodes
+
+    std::vector<Triangle> tris;
+    std::vector<BVHNode> nodes;
+    int depth = 0;                          // Deepest leaf, root = 0
+
+    // False if the tree is too deep for occluded() to walk
+    bool build(std::vector<Triangle> triangles) {
+        tris = std::move(triangles);
+        std::vector<glm::vec3> centroids(tris.size());
+        for (size_t i = 0; i < tris.size(); ++i) {
+            centroids[i] = tris[i].v0 + (tris[i].e1 + tris[i].e2) / 3.0f;
+        }
+        nodes.reserve(tris.size() * 2);
+        nodes.push_back({});
+        depth = 0;
+        split(0, 0, (int)tris.size(), 0, centroids);
+        return depth <= MAX_DEPTH;
+    }
+
+    void split(int nodeIndex, int first, int count, int level, std::vector<glm::vec3>& centroids) {
+        depth = std::max(depth, level);
+        glm::vec3 lo(1e30f), hi(-1e30f), clo(1e30f), chi(-1e30f);
+        for (int i = first; i < first + count; ++i) {
+            const Triangle& t = tris[i];
+            for (const glm::vec3& p : { t.v0, t.v0 + t.e1, t.v0 + t.e2 }) {
+                lo = glm::min(lo, p);
+                hi = glm::max(hi, p);
+            }
+            clo = glm::min(clo, centroids[i]);
+            chi = glm::max(chi, centroids[i]);
+        }
+        nodes[nodeIndex].lo = lo;
+        nodes[nodeIndex].hi = hi;
+
+        if (count <= 4) {
+            nodes[nodeIndex].first = first;
+            nodes[nodeIndex].count = count;
+            return;
+        }
+
+        // Median split on the widest centroid axis
+        glm::vec3 extent = chi - clo;
+        int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+        int mid = first + count / 2;
+
+        std::vector<int> order(count);
+        for (int i = 0; i < count; ++i) order[i] = first + i;
+        std::nth_element(order.begin(), order.begin() + count / 2, order.end(),
+                         [&](int a, int b) { return centroids[a][axis] < centroids[b][axis]; });
+        std::vector<Triangle> sortedTris(count);
+        std::vector<glm::vec3> sortedCentroids(count);
+        for (int i = 0; i < count; ++i) {
+            sortedTris[i] = tris[order[i]];
+            sortedCentroids[i] = centroids[order[i]];
+        }
+        std::copy(sortedTris.begin(), sortedTris.end(), tris.begin() + first);
+        std::copy(sortedCentroids.begin(), sortedCentroids.end(), centroids.begin() + first);
+
+        int left = (int)nodes.size();
+        nodes.push_back({});
+        nodes.push_back({});
+        nodes[nodeIndex].first = left;
+        nodes[nodeIndex].count = 0;
+        split(left, first, mid - first, level + 1, centroids);
+        split(left + 1, mid, first + count - mid, level + 1, centroids);
+    }
+
+    static bool hit_box(const BVHNode& n, const glm::vec3& o, const glm::vec3& invDir, float tMax) {
+        float t0 = 0.0f, t1 = tMax;
+        for (int a = 0; a < 3; ++a) {
+            float tNear = (n.lo[a] - o[a]) * invDir[a];
+            float tFar  = (n.hi[a] - o[a]) * invDir[a];
+            if (tNear > tFar) std::swap(tNear, tFar);
+            t0 = std::max(t0, tNear);
+            t1 = std::min(t1, tFar);
+            if (t0 > t1) return false;
+        }
+        return true;
+    }
+
+    static bool hit_triangle(const Triangle& t, const glm::vec3& o, const glm::vec3& d, float tMax) {
+        glm::vec3 p = glm::cross(d, t.e2);
+        float det = glm::dot(t.e1, p);
+        if (std::abs(det) < 1e-8f) return false;
+        float invDet = 1.0f / det;
+        glm::vec3 s = o - t.v0;
+        float u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+        glm::vec3 q = glm::cross(s, t.e1);
+        float v = glm::dot(d, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+        float dist = glm::dot(t.e2, q) * invDet;
+        return dist > 0.0f && dist < tMax;
+    }
+
+    // Any hit along o + d * [0, tMax). Depth-first, so the stack never holds more than
+    // one pending sibling per level plus the node being split: depth + 1 <= MAX_DEPTH + 1.
+    bool occluded(const glm::vec3& o, const glm::vec3& d, float tMax) const {
+        glm::vec3 invDir(1.0f / d.x, 1.0f / d.y, 1.0f / d.z);
+        int stack[MAX_DEPTH + 1];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const BVHNode& n = nodes[stack[--top]];
+            if (!hit_box(n, o, invDir, tMax)) continue;
+            if (n.count > 0) {
+                for (int i = n.first; i < n.first + n.count; ++i) {
+                    if (hit_triangle(tris[i], o, d, tMax)) return true;
+                }
+            } else {
+                stack[top++] = n.first;
+                stack[top++] = n.first + 1;
+            }
+        }
+        return false;
+    }
+};
+
+// ---------------------------------------------------------
+// Per-vertex bake
+// ---------------------------------------------------------
+struct BakeVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+};
+
+uint32_t hash_u32(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+glm::vec3 bake_vertex(const BakeVertex& v, uint32_t seed, const BVH& bvh,
+                      const PointLight* lights, int lightCount, const Settings& settings,
+                      uint64_t& rays) {
+    glm::vec3 n = glm::normalize(v.normal);
+    glm::vec3 origin = v.position + n * 1e-3f;
+
+    // Tangent frame for hemisphere sampling
+    glm::vec3 t = std::abs(n.x) > 0.9f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+    t = glm::normalize(glm::cross(n, t));
+    glm::vec3 b = glm::cross(n, t);
+
+    // 1. Ambient occlusion (cosine-weighted hemisphere)
+    int open = 0;
+    uint32_t rng = hash_u32(seed);
+    for (int i = 0; i < settings.aoRays; ++i) {
+        rng = hash_u32(rng + i);
+        float u1 = (rng & 0xffff) / 65536.0f;
+        float u2 = (rng >> 16) / 65536.0f;
+        float r = std::sqrt(u1);
+        float phi = 6.2831853f * u2;
+        glm::vec3 dir = t * (r * std::cos(phi)) + b * (r * std::sin(phi)) + n * std::sqrt(1.0f - u1);
+        if (!bvh.occluded(origin, dir, settings.aoRadius)) open++;
+    }
+    rays += settings.aoRays;
+    float ao = settings.aoRays > 0 ? (float)open / settings.aoRays : 1.0f;
+
+    // 2. Static lights (same falloff as retro.frag), with one shadow ray each
+    glm::vec3 color = AMBIENT_COLOR * ao;
+    for (int i = 0; i < lightCount; ++i) {
+        glm::vec3 toLight = lights[i].position - v.position;
+        float distance = glm::length(toLight);
+        if (distance >= lights[i].range || distance < 1e-4f) continue;
+
+        glm::vec3 dir = toLight / distance;
+        float diff = glm::dot(n, dir);
+        if (diff <= 0.0f) continue;
+
+        rays++;
+        if (bvh.occluded(origin, dir, distance - 2e-3f)) continue;
+
+        float attenuation = 1.0f - distance / lights[i].range;
+        color += lights[i].color * (diff * attenuation);
+    }
+    return color;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printf("usage: %s <in.obj> <out.hpmesh> [lights] [--ao-rays N] [--ao-radius R] [--threads N]\n", argv[0]);
+        return 1;
+    }
+
+    const char* inPath = argv[1];
+    const char* outPath = argv[2];
+    const char* lightPath = nullptr;
+    Settings settings;
+    for (int i = 3; i < argc; ++i) {
+        if (!strcmp(argv[i], "--ao-rays") && i + 1 < argc) settings.aoRays = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--ao-radius") && i + 1 < argc) settings.aoRadius = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) settings.threads = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && !lightPath) lightPath = argv[i];
+        else {
+            printf("[bake] unknown or incomplete argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (settings.threads <= 0) settings.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    using Clock = std::chrono::steady_clock;
+    auto ms_since = [](Clock::time_point t) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - t).count();
+    };
+
+    // --- 1. Load ---
+    auto loadStart = Clock::now();
+    MeshData mesh;
+    if (!load_obj_mesh(inPath, mesh)) return 1;
+
+    std::vector<PointLight> lights(256);
+    int lightCount = lightPath ? load_light_file(lightPath, lights.data(), (int)lights.size()) : 0;
+    printf("[bake] loaded %zu buckets, %d static lights in %.1f ms\n", mesh.buckets.size(), lightCount, ms_since(loadStart));
+
+    // --- 2. Triangles + unique vertices ---
+    // OBJ faces are unrolled, so the same (position, normal) shows up once per face.
+    // Bake each unique one once and scatter back.
+    auto bvhStart = Clock::now();
+    std::vector<Triangle> triangles;
+    std::vector<BakeVertex> unique;
+    std::vector<std::vector<uint32_t>> remap(mesh.buckets.size());
+    std::unordered_map<std::string, uint32_t> seen;
+
+    for (size_t b = 0; b < mesh.buckets.size(); ++b) {
+        const std::vector<float>& data = mesh.buckets[b].vertices;
+        size_t vertexCount = data.size() / MeshData::MESH_STRIDE;
+        remap[b].resize(vertexCount);
+
+        for (size_t v = 0; v < vertexCount; ++v) {
+            const float* src = &data[v * MeshData::MESH_STRIDE];
+            BakeVertex bv = { glm::vec3(src[0], src[1], src[2]), glm::vec3(src[5], src[6], src[7]) };
+
+            std::string key(reinterpret_cast<const char*>(&bv), sizeof(bv));
+            auto [it, inserted] = seen.emplace(key, (uint32_t)unique.size());
+            if (inserted) unique.push_back(bv);
+            remap[b][v] = it->second;
+
+            if (v % 3 == 2) {
+                glm::vec3 p0(src[-16], src[-15], src[-14]);
+                glm::vec3 p1(src[-8], src[-7], src[-6]);
+                glm::vec3 p2(src[0], src[1], src[2]);
+                triangles.push_back({ p0, p1 - p0, p2 - p0 });
+            }
+        }
+    }
+
+    size_t triangleCount = triangles.size();
+    BVH bvh;
+    if (!bvh.build(std::move(triangles))) {
+        printf("[bake] BVH is %d levels deep, occlusion rays only walk %d\n", bvh.depth, BVH::MAX_DEPTH);
+        return 1;
+    }
+    printf("[bake] %zu triangles, %zu unique vertices, BVH %zu nodes, depth %d in %.1f ms\n",
+           triangleCount, unique.size(), bvh.nodes.size(), bvh.depth, ms_since(bvhStart));
+
+    // --- 3. Bake (work-stealing over fixed chunks) ---
+    auto bakeStart = Clock::now();
+    std::vector<glm::vec3> baked(unique.size());
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<uint64_t> totalRays{0};
+    const size_t kChunk = 256;
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < settings.threads; ++w) {
+        workers.emplace_back([&]() {
+            uint64_t rays = 0;
+            for (;;) {
+                size_t begin = nextChunk.fetch_add(kChunk);
+                if (begin >= unique.size()) break;
+                size_t end = std::min(begin + kChunk, unique.size());
+                for (size_t i = begin; i < end; ++i) {
+                    baked[i] = bake_vertex(unique[i], (uint32_t)i, bvh, lights.data(), lightCount, settings, rays);
+                }
+            }
+            totalRays += rays;
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    double bakeMs = ms_since(bakeStart);
+    double seconds = std::max(bakeMs / 1000.0, 1e-9);
+    printf("[bake] %d threads, %.1f ms: %.0f vertices/s, %.2f Mrays/s (%llu rays)\n",
+           settings.threads, bakeMs, unique.size() / seconds, totalRays / seconds / 1e6,
+           (unsigned long long)totalRays.load());
+
+    // --- 4. Write pos/uv/normal + baked color ---
+    MeshData out;
+    out.stride = MeshData::MESH_BAKED_STRIDE;
+    for (size_t b = 0; b < mesh.buckets.size(); ++b) {
+        const MeshData::Bucket& in = mesh.buckets[b];
+        MeshData::Bucket bucket;
+        bucket.material = in.material;
+        bucket.texture = in.texture;
+
+        size_t vertexCount = in.vertices.size() / MeshData::MESH_STRIDE;
+        bucket.vertices.resize(vertexCount * MeshData::MESH_BAKED_STRIDE);
+        for (size_t v = 0; v < vertexCount; ++v) {
+            float* dst = &bucket.vertices[v * MeshData::MESH_BAKED_STRIDE];
+            memcpy(dst, &in.vertices[v * MeshData::MESH_STRIDE], MeshData::MESH_STRIDE * sizeof(float));
+            const glm::vec3& c = baked[remap[b][v]];
+            dst[8] = c.x; dst[9] = c.y; dst[10] = c.z;
+        }
+        out.buckets.push_back(std::move(bucket));
+    }
+
+    if (!save_baked_mesh(outPath, out)) return 1;
+    printf("[bake] wrote %s\n", outPath);
+    return 0;
+}
@@ -0,0 +1,187 @@
+// hp3d_pack: bundles loose assets into one .hpak the runtime memory-maps.
+//
+// Every file is keyed by its path relative to <root> (the repo root, so the
+// runtime's "../assets/..." paths normalize to the same key). Entries that
+// shrink by more than 10% are stored LZ4HC compressed; PNGs and other already
+// compressed data stay raw so the runtime can hand out zero-copy views.
+//
+// Usage:
+//   hp3d_pack <out.hpak> <root> <file or dir>...
+//
+// e.g. (from the build dir)
+//   ./hp3d_pack level01.hpak .. assets/levels/01 assets/skharry.hpanim shaders
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <lz4hc.h>
+
+#include "asset_pack.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct InputFile {
+    std::string key;        // Normalized, root-relative
+    fs::path source;
+    uint64_t hash;
+};
+
+bool read_file(const fs::path& path, std::vector<char>& out) {
+    FILE* f = fopen(path.string().c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(size);
+    bool ok = fread(out.data(), 1, size, f) == (size_t)size;
+    fclose(f);
+    return ok;
+}
+
+void add_input(const fs::path& root, const fs::path& path, std::vector<InputFile>& inputs) {
+    InputFile in;
+    in.key = pack_normalize_path(fs::relative(path, root).generic_string().c_str());
+    in.source = path;
+    in.hash = pack_hash(in.key);
+    inputs.push_back(in);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        printf("usage: %s <out.hpak> <root> <file or dir>...\n", argv[0]);
+        return 1;
+    }
+
+    const char* outPath = argv[1];
+    fs::path root = fs::absolute(argv[2]);
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    // --- 1. Collect ---
+    std::vector<InputFile> inputs;
+    for (int i = 3; i < argc; ++i) {
+        fs::path path = root / argv[i];
+        if (fs::is_directory(path)) {
+            for (const auto& item : fs::recursive_directory_iterator(path)) {
+                if (item.is_regular_file()) add_input(root, item.path(), inputs);
+            }
+        } else if (fs::is_regular_file(path)) {
+            add_input(root, path, inputs);
+        } else {
+            printf("[pack] missing input: %s\n", path.string().c_str());
+            return 1;
+        }
+    }
+
+    // TOC order is hash order (the runtime binary searches it)
+    std::sort(inputs.begin(), inputs.end(), [](const InputFile& a, const InputFile& b) { return a.hash < b.hash; });
+    inputs.erase(std::unique(inputs.begin(), inputs.end(),
+                             [](const InputFile& a, const InputFile& b) { return a.key == b.key; }),
+                 inputs.end());
+    for (size_t i = 1; i < inputs.size(); ++i) {
+        if (inputs[i].hash == inputs[i - 1].hash) {
+            printf("[pack] hash collision: %s / %s\n", inputs[i - 1].key.c_str(), inputs[i].key.c_str());
+            return 1;
+        }
+    }
+
+    // --- 2. Layout: header, TOC, strings, then aligned blobs ---
+    std::vector<PackEntry> entries(inputs.size());
+    std::string strings;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        entries[i].hash = inputs[i].hash;
+        entries[i].pathOffset = (uint32_t)strings.size();
+        strings += inputs[i].key;
+        strings += '\0';
+    }
+
+    PackHeader header = {};
+    memcpy(header.magic, PACK_MAGIC, sizeof(header.magic));
+    header.version = PACK_VERSION;
+    header.entryCount = (uint32_t)entries.size();
+    header.tocOffset = sizeof(PackHeader);
+    header.stringsOffset = header.tocOffset + entries.size() * sizeof(PackEntry);
+
+    auto align = [](uint64_t offset) { return (offset + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1); };
+    uint64_t cursor = align(header.stringsOffset + strings.size());
+
+    // --- 3. Compress ---
+    std::vector<std::vector<char>> blobs(inputs.size());
+    uint64_t rawTotal = 0;
+    int compressedCount = 0;
+    std::vector<char> raw;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!read_file(inputs[i].source, raw)) {
+            printf("[pack] failed to read: %s\n", inputs[i].source.string().c_str());
+            return 1;
+        }
+
+        PackEntry& entry = entries[i];
+        entry.rawSize = raw.size();
+        entry.compression = PACK_RAW;
+        blobs[i] = raw;
+
+        if (!raw.empty()) {
+            std::vector<char> packed(LZ4_compressBound((int)raw.size()));
+            int packedSize = LZ4_compress_HC(raw.data(), packed.data(), (int)raw.size(), (int)packed.size(), LZ4HC_CLEVEL_MAX);
+            // Only worth a decompress at load time if it actually saves something
+            if (packedSize > 0 && (uint64_t)packedSize * 10 < raw.size() * 9) {
+                packed.resize(packedSize);
+                blobs[i] = std::move(packed);
+                entry.compression = PACK_LZ4;
+                compressedCount++;
+            }
+        }
+
+        entry.storedSize = blobs[i].size();
+        entry.offset = cursor;
+        cursor = align(cursor + entry.storedSize);
+        rawTotal += entry.rawSize;
+    }
+
+    // --- 4. Write ---
+    FILE* f = fopen(outPath, "wb");
+    if (!f) {
+        printf("[pack] cannot write %s\n", outPath);
+        return 1;
+    }
+    static const char zeros[PACK_ALIGNMENT] = {};
+    uint64_t written = 0;
+    auto write = [&](const void* data, size_t size) {
+        fwrite(data, 1, size, f);
+        written += size;
+    };
+    auto pad_to = [&](uint64_t offset) {
+        while (written < offset) write(zeros, std::min<uint64_t>(offset - written, PACK_ALIGNMENT));
+    };
+
+    write(&header, sizeof(header));
+    write(entries.data(), entries.size() * sizeof(PackEntry));
+    write(strings.data(), strings.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        pad_to(entries[i].offset);
+        write(blobs[i].data(), blobs[i].size());
+    }
+    bool ok = ferror(f) == 0;
+    fclose(f);
+    if (!ok) {
+        printf("[pack] write failed: %s\n", outPath);
+        return 1;
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    printf("[pack] %s: %zu files (%d lz4), %.2f MB -> %.2f MB in %.1f ms\n",
+           outPath, entries.size(), compressedCount,
+           rawTotal / (1024.0 * 1024.0), written / (1024.0 * 1024.0), ms);
+    return 0;
+}